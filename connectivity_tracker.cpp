@@ -0,0 +1,108 @@
+//----------------------------------------------------------------------
+// NAME: Sami Blevens
+// FILE: connectivity_tracker.cpp
+// DATE: Spring 2021
+// DESC: Graph wrapper that keeps a union-find of the (weakly)
+// connected components up to date as edges are added
+//----------------------------------------------------------------------
+
+#ifndef CONNECTIVITY_TRACKER_CPP
+#define CONNECTIVITY_TRACKER_CPP
+
+#include "connectivity_tracker.h"
+
+ConnectivityTracker::ConnectivityTracker(Graph& graph)
+   : graph(graph), components(0), stale(true) {
+   rebuild();
+}
+
+void ConnectivityTracker::set_edge(int v1, int edge_label, int v2){
+   graph.set_edge(v1,edge_label,v2);
+   if(stale)
+      return;
+   int a = find(v1);
+   int b = find(v2);
+   if(a == b)
+      return;
+   //union by size
+   if(size[a] < size[b])
+      std::swap(a,b);
+   parent[b] = a;
+   size[a] += size[b];
+   --components;
+}
+
+bool ConnectivityTracker::has_edge(int v1, int v2) const {
+   return graph.has_edge(v1,v2);
+}
+
+bool ConnectivityTracker::get_edge(int v1, int v2, int& edge) const {
+   return graph.get_edge(v1,v2,edge);
+}
+
+void ConnectivityTracker::remove_edge(int v1, int v2){
+   if(graph.has_edge(v1,v2)){
+      graph.remove_edge(v1,v2);
+      //union-find cannot split, so recompute lazily
+      stale = true;
+   }
+}
+
+void ConnectivityTracker::connected_to(int v1, std::list<int>& vertices) const {
+   graph.connected_to(v1,vertices);
+}
+
+void ConnectivityTracker::connected_from(int v2, std::list<int>& vertices) const {
+   graph.connected_from(v2,vertices);
+}
+
+void ConnectivityTracker::adjacent(int v, std::list<int>& vertices) const {
+   graph.adjacent(v,vertices);
+}
+
+int ConnectivityTracker::vertex_count() const {
+   return graph.vertex_count();
+}
+
+int ConnectivityTracker::edge_count() const {
+   return graph.edge_count();
+}
+
+bool ConnectivityTracker::connected(int v1, int v2){
+   if(stale)
+      rebuild();
+   return find(v1) == find(v2);
+}
+
+int ConnectivityTracker::component_count(){
+   if(stale)
+      rebuild();
+   return components;
+}
+
+int ConnectivityTracker::find(int v){
+   while(parent[v] != v){
+      parent[v] = parent[parent[v]];
+      v = parent[v];
+   }
+   return v;
+}
+
+void ConnectivityTracker::rebuild(){
+   std::vector<int> labels;
+   components = graph.union_find_connected_components(labels);
+   int n = graph.vertex_count();
+   //the first vertex seen with each label becomes that component's root
+   std::vector<int> roots(components,-1);
+   parent.assign(n,0);
+   size.assign(n,0);
+   for(int i=0; i<n; ++i){
+      if(roots[labels[i]] == -1)
+         roots[labels[i]] = i;
+      parent[i] = roots[labels[i]];
+      ++size[parent[i]];
+   }
+   stale = false;
+}
+
+#endif
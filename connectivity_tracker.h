@@ -0,0 +1,80 @@
+//----------------------------------------------------------------------
+// NAME: Sami Blevens
+// FILE: connectivity_tracker.h
+// DATE: Spring 2021
+// DESC: Graph wrapper that keeps a union-find of the (weakly)
+// connected components up to date as edges are added
+//----------------------------------------------------------------------
+
+#ifndef CONNECTIVITY_TRACKER_H
+#define CONNECTIVITY_TRACKER_H
+
+#include "graph.h"
+
+
+class ConnectivityTracker : public Graph
+{
+public:
+
+  // attach a tracker to an existing graph (the graph must outlive the
+  // tracker, and edges should be changed through the tracker)
+  ConnectivityTracker(Graph& graph);
+
+  // add or update an edge, merging the components of v1 and v2
+  void set_edge(int v1, int edge_label, int v2);
+
+  // check if the given edge is in the graph
+  bool has_edge(int v1, int v2) const;  
+
+  // returns true if there is an edge between v1 and v2 in the graph
+  // the output parameter returns the edge label
+  bool get_edge(int v1, int v2, int& edge) const; 
+
+  // remove edge between v1 and v2 if the edge exists (components are
+  // recomputed on the next connectivity query)
+  void remove_edge(int v1, int v2);
+  
+  // get all vertices on an outgoing edge from given vertex
+  void connected_to(int v1, std::list<int>& vertices) const;
+
+  // get all vertices on an incoming edge to given vertex
+  void connected_from(int v2, std::list<int>& vertices) const;
+
+  // get all vertices adjacent to a vertex, that is, connected to or connected
+  // from the vertex (may return duplicate vertices)
+  void adjacent(int v, std::list<int>& vertices) const;
+
+  // get number of nodes in the graph
+  int vertex_count() const; 
+
+  // get number of edges in the graph
+  int edge_count() const; 
+
+  // true if v1 and v2 are in the same (weakly) connected component
+  bool connected(int v1, int v2);
+
+  // number of (weakly) connected components
+  int component_count();
+  
+private:
+
+  Graph& graph;
+
+  // union-find forest with component sizes stored at the roots
+  std::vector<int> parent;
+  std::vector<int> size;
+  int components;
+
+  // true if an edge was removed since the last rebuild
+  bool stale;
+
+  // find the root of v's component (with path halving)
+  int find(int v);
+
+  // recompute the union-find from scratch over the current edges
+  void rebuild();
+
+};
+
+
+#endif
@@ -0,0 +1,265 @@
+//----------------------------------------------------------------------
+// NAME: Sami Blevens
+// FILE: distance_oracle.cpp
+// DATE: Spring 2021
+// DESC: Landmark-based distance oracle giving lower and upper bounds
+// on u-v shortest path distances from the distances to and from a
+// few landmark vertices
+//----------------------------------------------------------------------
+
+#ifndef DISTANCE_ORACLE_CPP
+#define DISTANCE_ORACLE_CPP
+
+#include "distance_oracle.h"
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <queue>
+#include <thread>
+
+DistanceOracle::DistanceOracle()
+   : number_of_vertices(0), directed(false), weighted(false) {
+}
+
+DistanceOracle::DistanceOracle(const Graph& graph, int landmarks, bool dir,
+                               bool weighted)
+   : number_of_vertices(graph.vertex_count()), directed(dir), weighted(weighted) {
+   int n = number_of_vertices;
+
+   //edges out of (and, if directed, into) each vertex as flat arrays,
+   //with the smaller label of u->v and v->u for undirected edges
+   std::vector<int> out_offsets(n+1, 0);
+   std::vector<int> out_targets;
+   std::vector<int> out_weights;
+   std::vector<int> in_offsets(n+1, 0);
+   std::vector<int> in_targets;
+   std::vector<int> in_weights;
+   std::list<int> adj_v;
+   for(int u=0; u<n; ++u){
+      adj_v.clear();
+      if(dir)
+         graph.connected_to(u,adj_v);
+      else
+         graph.adjacent(u,adj_v);
+      adj_v.sort();
+      adj_v.unique();
+      for(int v: adj_v){
+         int forward;
+         int backward;
+         bool has_forward = graph.get_edge(u,v,forward);
+         bool has_backward = !dir && graph.get_edge(v,u,backward);
+         if(!has_forward || (has_backward && backward < forward))
+            forward = backward;
+         out_targets.push_back(v);
+         out_weights.push_back(forward);
+      }
+      out_offsets[u+1] = out_targets.size();
+      if(dir){
+         adj_v.clear();
+         graph.connected_from(u,adj_v);
+         adj_v.sort();
+         adj_v.unique();
+         for(int v: adj_v){
+            int label;
+            graph.get_edge(v,u,label);
+            in_targets.push_back(v);
+            in_weights.push_back(label);
+         }
+         in_offsets[u+1] = in_targets.size();
+      }
+   }
+
+   //landmarks are the vertices with the most edges
+   std::vector<int> order(n);
+   for(int v=0; v<n; ++v)
+      order[v] = v;
+   std::vector<int> degree(n);
+   for(int v=0; v<n; ++v){
+      degree[v] = out_offsets[v+1] - out_offsets[v];
+      if(dir)
+         degree[v] += in_offsets[v+1] - in_offsets[v];
+   }
+   int k = std::max(0, std::min(landmarks, n));
+   std::partial_sort(order.begin(), order.begin() + k, order.end(),
+                     [&](int a, int b){
+                        return degree[a] > degree[b] || (degree[a] == degree[b] && a < b);
+                     });
+   this->landmarks.assign(order.begin(), order.begin() + k);
+
+   //each landmark fills its own contiguous rows, which are transposed
+   //into the vertex-major layout once all trees are done
+   int trees = dir ? 2*k : k;
+   std::vector<std::vector<long long>> rows(trees);
+   std::atomic<int> next(0);
+   std::function<void()> worker = [&](){
+      for(int t = next++; t < trees; t = next++){
+         if(t < k)
+            shortest_paths(t, out_offsets, out_targets, out_weights, rows[t]);
+         else
+            shortest_paths(t - k, in_offsets, in_targets, in_weights, rows[t]);
+      }
+   };
+   int threads = std::max(1, std::min<int>(trees, std::thread::hardware_concurrency()));
+   std::vector<std::thread> workers;
+   for(int i=1; i<threads; ++i)
+      workers.push_back(std::thread(worker));
+   worker();
+   for(std::thread& t: workers)
+      t.join();
+
+   from.assign((size_t)n*k, -1);
+   if(dir)
+      to.assign((size_t)n*k, -1);
+   for(int v=0; v<n; ++v){
+      for(int i=0; i<k; ++i){
+         from[(size_t)v*k + i] = rows[i][v];
+         if(dir)
+            to[(size_t)v*k + i] = rows[k + i][v];
+      }
+   }
+}
+
+bool DistanceOracle::distance_bounds(int u, int v, long long& lower, long long& upper) const {
+   lower = 0;
+   upper = -1;
+   if(u == v){
+      upper = 0;
+      return true;
+   }
+   int k = landmark_count();
+   const long long* from_u = &from[(size_t)u*k];
+   const long long* from_v = &from[(size_t)v*k];
+   //undirected distances to a landmark are the same as from it
+   const long long* to_u = directed ? &to[(size_t)u*k] : from_u;
+   const long long* to_v = directed ? &to[(size_t)v*k] : from_v;
+   for(int i=0; i<k; ++i){
+      //u -> landmark -> v is a path
+      if(to_u[i] >= 0 && from_v[i] >= 0){
+         long long through = to_u[i] + from_v[i];
+         if(upper == -1 || through < upper)
+            upper = through;
+      }
+      //landmark -> u -> v and u -> v -> landmark
+      if(from_u[i] >= 0){
+         if(from_v[i] < 0)
+            return false;
+         lower = std::max(lower, from_v[i] - from_u[i]);
+      }
+      if(to_v[i] >= 0){
+         if(to_u[i] < 0)
+            return false;
+         lower = std::max(lower, to_u[i] - to_v[i]);
+      }
+   }
+   //every edge is one step when unweighted
+   if(!weighted)
+      lower = std::max(lower, 1LL);
+   return true;
+}
+
+int DistanceOracle::vertex_count() const {
+   return number_of_vertices;
+}
+
+int DistanceOracle::landmark_count() const {
+   return landmarks.size();
+}
+
+void DistanceOracle::save(std::ostream& out) const {
+   int n = vertex_count();
+   int k = landmark_count();
+   out << n << " " << k << " " << directed << " " << weighted << "\n";
+   for(int l: landmarks)
+      out << l << " ";
+   out << "\n";
+   for(long long d: from)
+      out << d << " ";
+   out << "\n";
+   for(long long d: to)
+      out << d << " ";
+   out << "\n";
+}
+
+bool DistanceOracle::load(std::istream& in){
+   int n;
+   int k;
+   bool dir;
+   bool use_weights;
+   if(!(in >> n >> k >> dir >> use_weights) || n < 0 || k < 0 || k > n)
+      return false;
+   //read into locals so a bad stream leaves the oracle unchanged
+   std::vector<int> in_landmarks(k,0);
+   std::vector<long long> in_from((size_t)n*k,-1);
+   std::vector<long long> in_to(dir ? (size_t)n*k : 0,-1);
+   for(int i=0; i<k; ++i)
+      in >> in_landmarks[i];
+   for(size_t i=0; i<in_from.size(); ++i)
+      in >> in_from[i];
+   for(size_t i=0; i<in_to.size(); ++i)
+      in >> in_to[i];
+   if(!in)
+      return false;
+   //distances are -1 (no path) or non-negative
+   for(long long d: in_from){
+      if(d < -1)
+         return false;
+   }
+   for(long long d: in_to){
+      if(d < -1)
+         return false;
+   }
+   for(int l: in_landmarks){
+      if(l < 0 || l >= n)
+         return false;
+   }
+   number_of_vertices = n;
+   directed = dir;
+   weighted = use_weights;
+   landmarks.swap(in_landmarks);
+   from.swap(in_from);
+   to.swap(in_to);
+   return true;
+}
+
+void DistanceOracle::shortest_paths(int i, const std::vector<int>& offsets,
+                                    const std::vector<int>& targets,
+                                    const std::vector<int>& weights,
+                                    std::vector<long long>& dist) const {
+   int src = landmarks[i];
+   dist.assign(number_of_vertices, -1);
+   dist[src] = 0;
+   if(!weighted){
+      std::vector<int> queue(1, src);
+      for(size_t j=0; j<queue.size(); ++j){
+         int u = queue[j];
+         for(int e=offsets[u]; e<offsets[u+1]; ++e){
+            int v = targets[e];
+            if(dist[v] == -1){
+               dist[v] = dist[u] + 1;
+               queue.push_back(v);
+            }
+         }
+      }
+      return;
+   }
+   typedef std::pair<long long,int> Entry;
+   std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+   heap.push(Entry(0, src));
+   while(!heap.empty()){
+      Entry top = heap.top();
+      heap.pop();
+      int u = top.second;
+      if(top.first != dist[u])
+         continue;
+      for(int e=offsets[u]; e<offsets[u+1]; ++e){
+         int v = targets[e];
+         long long d = top.first + weights[e];
+         if(dist[v] == -1 || d < dist[v]){
+            dist[v] = d;
+            heap.push(Entry(d, v));
+         }
+      }
+   }
+}
+
+#endif
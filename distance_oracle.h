@@ -0,0 +1,80 @@
+//----------------------------------------------------------------------
+// NAME: Sami Blevens
+// FILE: distance_oracle.h
+// DATE: Spring 2021
+// DESC: Landmark-based distance oracle giving lower and upper bounds
+// on u-v shortest path distances from the distances to and from a
+// few landmark vertices
+//----------------------------------------------------------------------
+
+#ifndef DISTANCE_ORACLE_H
+#define DISTANCE_ORACLE_H
+
+#include <iostream>
+#include "graph.h"
+
+
+class DistanceOracle
+{
+public:
+
+  // empty oracle (to be filled in by load)
+  DistanceOracle();
+
+  // build the oracle for the given graph using (up to) the given number
+  // of landmarks, chosen as the vertices of highest degree. The
+  // shortest path trees of the landmarks (breadth-first search, or
+  // dijkstra over the edge labels when weighted) are computed in
+  // parallel. Assumes non-negative edge labels when weighted.
+  DistanceOracle(const Graph& graph, int landmarks, bool dir = false,
+                 bool weighted = false);
+
+  // bounds on the distance from u to v in O(landmarks) time, using the
+  // triangle inequality through each landmark. Returns false if some
+  // landmark shows that u cannot reach v. Otherwise lower is at most
+  // the distance and upper is at least the distance, or -1 if no
+  // landmark lies on a path from u to v.
+  bool distance_bounds(int u, int v, long long& lower, long long& upper) const;
+
+  // get number of vertices covered
+  int vertex_count() const;
+
+  // get number of landmarks
+  int landmark_count() const;
+
+  // write the oracle as whitespace-separated integers
+  void save(std::ostream& out) const;
+
+  // read an oracle written by save, returns false if it is malformed
+  bool load(std::istream& in);
+
+private:
+
+  // number of vertices covered
+  int number_of_vertices;
+
+  // true if built over a directed graph, and if edge labels were used
+  bool directed;
+  bool weighted;
+
+  // the landmark vertices
+  std::vector<int> landmarks;
+
+  // distances from each landmark to each vertex and (if directed) from
+  // each vertex to each landmark, -1 if there is no path, stored by
+  // vertex as from[v*k + i] for landmark i so a query reads two short
+  // contiguous rows
+  std::vector<long long> from;
+  std::vector<long long> to;
+
+  // helper function to fill in dist[v], the distance from landmark i to
+  // each vertex v (or -1), over the given flat edge arrays
+  void shortest_paths(int i, const std::vector<int>& offsets,
+                      const std::vector<int>& targets,
+                      const std::vector<int>& weights,
+                      std::vector<long long>& dist) const;
+
+};
+
+
+#endif
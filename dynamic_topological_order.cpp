@@ -0,0 +1,195 @@
+//----------------------------------------------------------------------
+// NAME: Sami Blevens
+// FILE: dynamic_topological_order.cpp
+// DATE: Spring 2021
+// DESC: Graph wrapper that maintains a topological order of a
+// directed graph as edges are added (Pearce-Kelly algorithm)
+//----------------------------------------------------------------------
+
+#ifndef DYNAMIC_TOPOLOGICAL_ORDER_CPP
+#define DYNAMIC_TOPOLOGICAL_ORDER_CPP
+
+#include "dynamic_topological_order.h"
+#include <algorithm>
+#include <unordered_set>
+
+DynamicTopologicalOrder::DynamicTopologicalOrder(Graph& graph)
+   : graph(graph), stale(true) {
+   rebuild();
+}
+
+void DynamicTopologicalOrder::set_edge(int v1, int edge_label, int v2){
+   bool existed = graph.has_edge(v1,v2);
+   graph.set_edge(v1,edge_label,v2);
+   if(!existed && !stale && !reorder(v1,v2))
+      stale = true;
+}
+
+bool DynamicTopologicalOrder::try_set_edge(int v1, int edge_label, int v2){
+   if(graph.has_edge(v1,v2)){
+      graph.set_edge(v1,edge_label,v2);
+      return true;
+   }
+   if(stale && !rebuild()){
+      //already cyclic, so only check if v1 is reachable from v2
+      Map tree;
+      graph.bfs(true,v2,tree);
+      if(tree.count(v1))
+         return false;
+      graph.set_edge(v1,edge_label,v2);
+      return true;
+   }
+   if(!reorder(v1,v2))
+      return false;
+   graph.set_edge(v1,edge_label,v2);
+   return true;
+}
+
+bool DynamicTopologicalOrder::has_edge(int v1, int v2) const {
+   return graph.has_edge(v1,v2);
+}
+
+bool DynamicTopologicalOrder::get_edge(int v1, int v2, int& edge) const {
+   return graph.get_edge(v1,v2,edge);
+}
+
+void DynamicTopologicalOrder::remove_edge(int v1, int v2){
+   graph.remove_edge(v1,v2);
+}
+
+void DynamicTopologicalOrder::connected_to(int v1, std::list<int>& vertices) const {
+   graph.connected_to(v1,vertices);
+}
+
+void DynamicTopologicalOrder::connected_from(int v2, std::list<int>& vertices) const {
+   graph.connected_from(v2,vertices);
+}
+
+void DynamicTopologicalOrder::adjacent(int v, std::list<int>& vertices) const {
+   graph.adjacent(v,vertices);
+}
+
+int DynamicTopologicalOrder::vertex_count() const {
+   return graph.vertex_count();
+}
+
+int DynamicTopologicalOrder::edge_count() const {
+   return graph.edge_count();
+}
+
+bool DynamicTopologicalOrder::acyclic(){
+   return !stale || rebuild();
+}
+
+int DynamicTopologicalOrder::order(int v){
+   if(!acyclic())
+      return -1;
+   return position[v] + 1;
+}
+
+bool DynamicTopologicalOrder::topological_order(Map& vertex_ordering){
+   vertex_ordering.clear();
+   if(!acyclic())
+      return false;
+   for(int v=0; v<vertex_count(); ++v){
+      vertex_ordering[v] = position[v] + 1;
+   }
+   return true;
+}
+
+bool DynamicTopologicalOrder::forward_region(int v, int u, int upper,
+                                             std::vector<int>& region) const {
+   std::unordered_set<int> visited;
+   std::vector<int> s(1,v);
+   visited.insert(v);
+   std::list<int> adj_v;
+   while(!s.empty()){
+      int x = s.back();
+      s.pop_back();
+      region.push_back(x);
+      adj_v.clear();
+      graph.connected_to(x,adj_v);
+      for(int w: adj_v){
+         if(w == u)
+            return false;
+         if(position[w] < upper && visited.count(w) == 0){
+            visited.insert(w);
+            s.push_back(w);
+         }
+      }
+   }
+   return true;
+}
+
+void DynamicTopologicalOrder::backward_region(int u, int lower,
+                                              std::vector<int>& region) const {
+   std::unordered_set<int> visited;
+   std::vector<int> s(1,u);
+   visited.insert(u);
+   std::list<int> adj_v;
+   while(!s.empty()){
+      int x = s.back();
+      s.pop_back();
+      region.push_back(x);
+      adj_v.clear();
+      graph.connected_from(x,adj_v);
+      for(int w: adj_v){
+         if(position[w] > lower && visited.count(w) == 0){
+            visited.insert(w);
+            s.push_back(w);
+         }
+      }
+   }
+}
+
+bool DynamicTopologicalOrder::reorder(int u, int v){
+   if(u == v)
+      return false;
+   int lower = position[v];
+   int upper = position[u];
+   if(lower > upper)
+      return true;
+
+   //only vertices positioned between v and u can need to move
+   std::vector<int> forward;
+   std::vector<int> backward;
+   if(!forward_region(v,u,upper,forward))
+      return false;
+   backward_region(u,lower,backward);
+
+   auto by_position = [&](int a, int b){ return position[a] < position[b]; };
+   std::sort(forward.begin(), forward.end(), by_position);
+   std::sort(backward.begin(), backward.end(), by_position);
+
+   //backward region (ending at u) goes before the forward region
+   //(starting at v), reusing the positions both regions occupied
+   std::vector<int> moved(backward);
+   moved.insert(moved.end(), forward.begin(), forward.end());
+   std::vector<int> slots;
+   for(int x: moved){
+      slots.push_back(position[x]);
+   }
+   std::sort(slots.begin(), slots.end());
+   for(int i=0; i<(int)moved.size(); ++i){
+      position[moved[i]] = slots[i];
+      vertex_at[slots[i]] = moved[i];
+   }
+   return true;
+}
+
+bool DynamicTopologicalOrder::rebuild(){
+   std::vector<int> ordering;
+   if(!graph.kahn_topological_sort(ordering))
+      return false;
+   int n = graph.vertex_count();
+   position.assign(n,0);
+   vertex_at.assign(n,0);
+   for(int v=0; v<n; ++v){
+      position[v] = ordering[v] - 1;
+      vertex_at[position[v]] = v;
+   }
+   stale = false;
+   return true;
+}
+
+#endif
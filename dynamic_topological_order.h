@@ -0,0 +1,98 @@
+//----------------------------------------------------------------------
+// NAME: Sami Blevens
+// FILE: dynamic_topological_order.h
+// DATE: Spring 2021
+// DESC: Graph wrapper that maintains a topological order of a
+// directed graph as edges are added (Pearce-Kelly algorithm)
+//----------------------------------------------------------------------
+
+#ifndef DYNAMIC_TOPOLOGICAL_ORDER_H
+#define DYNAMIC_TOPOLOGICAL_ORDER_H
+
+#include "graph.h"
+
+
+class DynamicTopologicalOrder : public Graph
+{
+public:
+
+  // attach to an existing directed graph (the graph must outlive this
+  // object, and edges should be changed through it)
+  DynamicTopologicalOrder(Graph& graph);
+
+  // add or update an edge, reordering only the vertices between v2 and
+  // v1 in the current order. An edge that closes a cycle is still
+  // added, but the order is then unavailable until the cycle is
+  // removed.
+  void set_edge(int v1, int edge_label, int v2);
+
+  // add the edge only if it does not close a cycle, returns false (and
+  // leaves the graph unchanged) otherwise
+  bool try_set_edge(int v1, int edge_label, int v2);
+
+  // check if the given edge is in the graph
+  bool has_edge(int v1, int v2) const;  
+
+  // returns true if there is an edge between v1 and v2 in the graph
+  // the output parameter returns the edge label
+  bool get_edge(int v1, int v2, int& edge) const; 
+
+  // remove edge between v1 and v2 if the edge exists (the current
+  // order stays valid)
+  void remove_edge(int v1, int v2);
+  
+  // get all vertices on an outgoing edge from given vertex
+  void connected_to(int v1, std::list<int>& vertices) const;
+
+  // get all vertices on an incoming edge to given vertex
+  void connected_from(int v2, std::list<int>& vertices) const;
+
+  // get all vertices adjacent to a vertex, that is, connected to or connected
+  // from the vertex (may return duplicate vertices)
+  void adjacent(int v, std::list<int>& vertices) const;
+
+  // get number of nodes in the graph
+  int vertex_count() const; 
+
+  // get number of edges in the graph
+  int edge_count() const; 
+
+  // true if the graph currently has no cycles
+  bool acyclic();
+
+  // position of v (from 1 to n) in the topological order, or -1 if the
+  // graph has a cycle
+  int order(int v);
+
+  // the current order as a map from vertex to position (from 1 to n),
+  // returns false (with an empty map) if the graph has a cycle
+  bool topological_order(Map& vertex_ordering);
+  
+private:
+
+  Graph& graph;
+
+  // position of each vertex (0 to n-1) and the vertex at each position
+  std::vector<int> position;
+  std::vector<int> vertex_at;
+
+  // true if a cycle was added since the last full sort
+  bool stale;
+
+  // dfs over out edges from v through vertices positioned at most
+  // upper, returns false if it reaches u (the edge u->v closes a cycle)
+  bool forward_region(int v, int u, int upper, std::vector<int>& region) const;
+
+  // dfs over in edges from u through vertices positioned at least lower
+  void backward_region(int u, int lower, std::vector<int>& region) const;
+
+  // reorder for a new edge u->v, returns false if it closes a cycle
+  bool reorder(int u, int v);
+
+  // recompute the order from scratch, returns false if there is a cycle
+  bool rebuild();
+
+};
+
+
+#endif
@@ -12,6 +12,14 @@
 #include <queue>
 #include <stack>
 #include <algorithm>
+#include <limits>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <map>
+#include <random>
+#include <cmath>
 
 void Graph::bfs(bool dir, int src, Map& tree) const {
    //set root
@@ -41,20 +49,65 @@ void Graph::bfs(bool dir, int src, Map& tree) const {
 }
 
 void Graph::shortest_path_length(bool dir, int src, int dst, std::list<int>& path) const {
-   Map search_tree;
-   bfs(dir,src,search_tree);
-   int parent = -1;
-   int child = dst;
-   path.push_front(dst);
-   while(parent!=src){
-      //if path does not connect/exist
-      if(search_tree.count(child)==0){
-         path.clear();
-         return;
+   path.clear();
+   if(src == dst)
+      return;
+   //search trees (vertex to parent) and hop distances from each end
+   Map fwd_tree;
+   Map bwd_tree;
+   Map fwd_dist;
+   Map bwd_dist;
+   fwd_tree[src] = -1;
+   fwd_dist[src] = 0;
+   bwd_tree[dst] = -1;
+   bwd_dist[dst] = 0;
+   std::vector<int> fwd_frontier(1,src);
+   std::vector<int> bwd_frontier(1,dst);
+   std::vector<int> next;
+   std::list<int> adj_v;
+   int meet = -1;
+
+   while(meet == -1 && !fwd_frontier.empty() && !bwd_frontier.empty()){
+      //expand a full level of the smaller frontier
+      bool forward = fwd_frontier.size() <= bwd_frontier.size();
+      std::vector<int>& frontier = forward ? fwd_frontier : bwd_frontier;
+      Map& tree = forward ? fwd_tree : bwd_tree;
+      Map& dist = forward ? fwd_dist : bwd_dist;
+      Map& other_dist = forward ? bwd_dist : fwd_dist;
+      int best = std::numeric_limits<int>::max();
+      next.clear();
+      for(int u: frontier){
+         adj_v.clear();
+         //directed graphs search backward from dst over incoming edges
+         if(!dir)
+            adjacent(u,adj_v);
+         else if(forward)
+            connected_to(u,adj_v);
+         else
+            connected_from(u,adj_v);
+         for(int v: adj_v){
+            if(tree.count(v) == 0){
+               tree[v] = u;
+               dist[v] = dist[u] + 1;
+               next.push_back(v);
+               Map::const_iterator it = other_dist.find(v);
+               if(it != other_dist.end() && dist[v] + it->second < best){
+                  best = dist[v] + it->second;
+                  meet = v;
+               }
+            }
+         }
       }
-      parent = search_tree[child];
-      path.push_front(parent);
-      child = parent;
+      frontier.swap(next);
+   }
+   if(meet == -1)
+      return;
+
+   for(int v = meet; v != -1; v = fwd_tree[v]){
+      path.push_front(v);
+   }
+   for(int v = bwd_tree[meet]; v != -1; v = bwd_tree[v]){
+      path.push_back(v);
    }
 }
 
@@ -294,250 +347,383 @@ void Graph::dfs_topological_sort(Map& vertex_ordering) const {
 
 
 void Graph::strongly_connected_components(Map& components) const {
-   //Full DFS on reverse graph
-   enum Color {
-      BLACK, GRAY, WHITE
-   };
-
-   Color *explored = new Color[vertex_count()];
+   std::vector<int> dense;
+   strongly_connected_components(dense);
    for(int i=0; i<vertex_count(); ++i){
-      explored[i] = WHITE;
+      components[i] = dense[i];
    }
+}
 
-   Map tree;
-   std::stack<int> s;
-   std::list<int> linearization;
-
-   for(int i=0; i<vertex_count(); ++i){
-      if(explored[i]==WHITE){
-         s.push(i);
-         while(!s.empty()){
-            int u = s.top();
-            if(explored[u]==GRAY){
-               s.pop();
-               explored[u]=BLACK;
-               linearization.push_front(u);
-               continue;
-            }
-            explored[u] = GRAY;
-
-            std::list<int> adj_v;
-            //connected_from to reverse the graph
-            connected_from(u, adj_v);
+int Graph::strongly_connected_components(std::vector<int>& components) const {
+   int n = vertex_count();
+   std::vector<int> offsets;
+   std::vector<int> targets;
+   flat_adjacency(OUT_EDGES, offsets, targets);
+
+   std::vector<int> index(n,-1);
+   std::vector<int> low(n,0);
+   components.assign(n,-1);
+   //vertices of components not yet completed
+   std::vector<int> scc_stack;
+   //explicit dfs call stack of vertices and their next edge positions
+   std::vector<int> call_v;
+   std::vector<int> call_edge;
+   int next_index = 0;
+   int c = 0;
 
-            if(adj_v.size()>0)
-               adj_v.sort();
-            for(int v: adj_v){
-               if(explored[v]==WHITE){
-                  s.push(v);
-               }
+   for(int s=0; s<n; ++s){
+      if(index[s] != -1)
+         continue;
+      index[s] = low[s] = next_index++;
+      scc_stack.push_back(s);
+      call_v.push_back(s);
+      call_edge.push_back(offsets[s]);
+      while(!call_v.empty()){
+         int v = call_v.back();
+         int k = call_edge.back();
+         if(k < offsets[v+1]){
+            call_edge.back() = k + 1;
+            int w = targets[k];
+            if(index[w] == -1){
+               index[w] = low[w] = next_index++;
+               scc_stack.push_back(w);
+               call_v.push_back(w);
+               call_edge.push_back(offsets[w]);
+            } else if(components[w] == -1){
+               //w is still on the scc stack
+               low[v] = std::min(low[v], index[w]);
             }
-            
-         }
-      }
-   }
-   delete [] explored;
-
-   //DFS on linearization
-   int c=0;
-   bool *discovered = new bool[vertex_count()];
-   for(int i=0; i<vertex_count(); ++i){
-      discovered[i] = false;
-   }
-   
-   for(int v: linearization){
-      std::stack<int> s;
-      if(discovered[v]==false){
-         c++;
-         s.push(v);
-      }
-         
-      while(!s.empty()){
-         int u = s.top();
-         if(discovered[u]==true){
-            s.pop();
             continue;
          }
-         discovered[u] = true;
-         components[u]=c;
-         std::list<int> adj_v;
-         connected_to(u, adj_v);
-         if(adj_v.size()>0)
-            adj_v.sort();
-         for(int adj: adj_v){
-            if(discovered[adj]==false){
-               s.push(adj);
-            }
+         call_v.pop_back();
+         call_edge.pop_back();
+         if(low[v] == index[v]){
+            int w;
+            do {
+               w = scc_stack.back();
+               scc_stack.pop_back();
+               components[w] = c;
+            } while(w != v);
+            ++c;
+         }
+         if(!call_v.empty()){
+            int u = call_v.back();
+            low[u] = std::min(low[u], low[v]);
          }
       }
-      
    }
-   delete [] discovered; 
+
+   //tarjan completes components in reverse topological order
+   for(int i=0; i<n; ++i){
+      components[i] = c - 1 - components[i];
+   }
+   return c;
 }
 
 void Graph::transitive_reduction(Graph& reduced_graph) const {
-   Map scc;
-   std::list<int> adj_v;
-   strongly_connected_components(scc);
-   std::unordered_map<int, std::list<int>> c_list;
+   std::vector<int> components;
+   std::vector<int> offsets;
+   std::vector<int> targets;
+   std::vector<std::vector<uint64_t>> reach;
+   int c = component_reachability(true, components, offsets, targets, reach);
+
+   //cycle for each component, the first vertex represents the component
+   std::vector<int> first_node(c,-1);
+   std::vector<int> prev_node(c,-1);
    for(int i=0; i<vertex_count(); ++i){
-      int index = scc[i];
-      c_list[index].push_back(i);
-   }
-
-   //cycle for each component
-   int metagraph[c_list.size()];
-   std::list<int> cur_component;
-   int first_node;
-   int prev_node;
-   for(int i=0; i<c_list.size(); ++i){
-      cur_component = c_list[i];
-      first_node = cur_component.front();
-      if(cur_component.size()>1){
-         while(cur_component.size()>1){
-            int edge1 = cur_component.front();
-            cur_component.pop_front();
-            prev_node = cur_component.front();
-            reduced_graph.set_edge(edge1,0,prev_node);
-         }
-         reduced_graph.set_edge(prev_node,0,first_node);
-      }
-      
-      cur_component.clear();
-      metagraph[i] = first_node;
+      int x = components[i];
+      if(first_node[x] == -1)
+         first_node[x] = i;
+      else
+         reduced_graph.set_edge(prev_node[x],0,i);
+      prev_node[x] = i;
+   }
+   for(int x=0; x<c; ++x){
+      if(prev_node[x] != first_node[x])
+         reduced_graph.set_edge(prev_node[x],0,first_node[x]);
    }
-   //set edges where paths exist between nodes in the metagraph
-   std::list<int> path;
-   for(int i=0; i<c_list.size(); ++i){
-      for(int j=0; j<c_list.size(); ++j){
-         path.clear();
-         if(i!=j){
-            shortest_path_length(true,metagraph[i],metagraph[j],path);
-            if(path.size()>0)
-               reduced_graph.set_edge(metagraph[i],0,metagraph[j]);
+
+   //successors are sorted in topological order, so any successor that
+   //makes an edge redundant is visited (or covered) before it
+   std::vector<std::vector<int>> kept(c);
+   int words = (c + 63) / 64;
+   parallel_for(c, [&](int start, int end){
+      std::vector<uint64_t> covered(words);
+      for(int x=start; x<end; ++x){
+         std::fill(covered.begin(), covered.end(), 0);
+         for(int k=offsets[x]; k<offsets[x+1]; ++k){
+            int y = targets[k];
+            if((covered[y/64] >> (y%64)) & 1)
+               continue;
+            kept[x].push_back(y);
+            for(int w=0; w<words; ++w){
+               covered[w] |= reach[y][w];
+            }
          }
       }
-   }
+   });
 
-   //irreducible 
-   
-   for(int i=0; i<vertex_count(); ++i){
-      adj_v.clear();
-      reduced_graph.connected_to(i,adj_v);
-      for(int v: adj_v){
-         reduced_graph.remove_edge(i,v);
-         reduced_graph.shortest_path_length(true,i,v,path);
-         if(path.empty())
-            reduced_graph.set_edge(i,0,v);
+   for(int x=0; x<c; ++x){
+      for(int y: kept[x]){
+         reduced_graph.set_edge(first_node[x],0,first_node[y]);
       }
    }
-
 }
 
 bool Graph::directed_eulerian_path(std::list<int>& path) const {
-   //check if eulerian path
-   int edge_count = 0;
+   int n = vertex_count();
+   if(n == 0)
+      return true;
+   std::vector<int> offsets;
+   std::vector<int> targets;
+   flat_adjacency(OUT_EDGES, offsets, targets);
+   std::vector<int> in_degree(n,0);
+   for(int v: targets){
+      ++in_degree[v];
+   }
+
+   //check if eulerian path: at most 1 source and sink, others balanced
    int source_count = 0;
    int sink_count = 0;
-   int source_vertex =0;
-   std::list<int> adj_to;
-   std::list<int> adj_from;
-   for(int i=0; i<vertex_count(); ++i){
-      adj_to.clear();
-      adj_from.clear();
-      connected_to(i, adj_to);
-      connected_from(i, adj_from);
-      if(adj_to.size() == adj_from.size()+1){ //check if source - i
+   int source_vertex = -1;
+   for(int i=0; i<n; ++i){
+      int out_degree = offsets[i+1] - offsets[i];
+      if(out_degree == in_degree[i] + 1){
          ++source_count;
          source_vertex = i;
-      } else if (adj_to.size()+1 == adj_from.size()){ // check if sink - ii
+      } else if(out_degree + 1 == in_degree[i]){
          ++sink_count;
-      } else if(adj_to.size() == adj_from.size()) { //same number of edges - iii
-         ++edge_count;
-      } else{
+      } else if(out_degree != in_degree[i]){
          return false;
       }
-   } 
-   //at most 1 source and sink
+   }
    if(source_count > 1 || sink_count > 1){
       return false;
-   } else if((vertex_count() - source_count - sink_count) != edge_count){
-      return false;
    }
-
-   //find eulerian path
-   std::unordered_map<int,std::list<int>> edges_left;
-   for(int i=0; i<vertex_count(); ++i){
-      std::list<int> adj;
-      connected_to(i,adj);
-      edges_left[i] = adj;
-      adj.clear();
+   if(source_vertex == -1){
+      source_vertex = 0;
+      for(int i=0; i<n; ++i){
+         if(offsets[i+1] > offsets[i]){
+            source_vertex = i;
+            break;
+         }
+      }
    }
 
-   std::stack<int> s;
-   s.push(source_vertex);
+   //find eulerian path, cursor[u] is u's next unused out edge
+   std::vector<int> cursor(offsets.begin(), offsets.end() - 1);
+   std::vector<int> s(1,source_vertex);
+   std::list<int> found;
    while(!s.empty()){
-      int u = s.top();
-      if(edges_left[u].size()<=0){
-         s.pop();
+      int u = s.back();
+      if(cursor[u] < offsets[u+1]){
+         s.push_back(targets[cursor[u]++]);
+      } else {
          //deadend - add to path
-         //std::cout << "dead end " << u << std::endl;
-         path.push_front(u);
-         continue;
+         s.pop_back();
+         found.push_front(u);
       }
-      
+   }
 
-      std::list<int> adj_v;
+   //edges in another component were never reached
+   if(found.size() != targets.size() + 1){
+      return false;
+   }
+   path.splice(path.end(), found);
+   return true;
+}
+
+
+bool Graph::directed_hamiltonian_path(std::list<int>& path) const {
+   bool timed_out;
+   return directed_hamiltonian_path(path, -1, timed_out);
+}
+
+bool Graph::directed_hamiltonian_path(std::list<int>& path, int time_limit_ms,
+                                      bool& timed_out) const {
+   timed_out = false;
+   int n = vertex_count();
+   if(n == 0)
+      return false;
+
+   //at most one vertex can have no incoming (the start) and one no
+   //outgoing (the end) edges
+   std::vector<int> starts;
+   int end_count = 0;
+   std::list<int> adj_v;
+   for(int v=0; v<n; ++v){
+      adj_v.clear();
+      connected_from(v,adj_v);
+      if(adj_v.empty())
+         starts.push_back(v);
+      adj_v.clear();
+      connected_to(v,adj_v);
+      if(adj_v.empty())
+         ++end_count;
+   }
+   if(n > 1 && (starts.size() > 1 || end_count > 1))
+      return false;
+
+   //the path must visit the components in topological order, so each
+   //component needs an edge to the next one
+   std::vector<int> components;
+   int c = strongly_connected_components(components);
+   std::vector<bool> linked(c,false);
+   for(int u=0; u<n; ++u){
+      adj_v.clear();
       connected_to(u,adj_v);
-      if(adj_v.size()>0)
-         adj_v.sort();
       for(int v: adj_v){
-         if((std::find(edges_left[u].begin(), edges_left[u].end(), v) != edges_left[u].end())){
-            edges_left[u].remove(v);
-            //std::cout << u << " " << v << std::endl;
-            s.push(v);
-         }
+         if(components[v] == components[u] + 1)
+            linked[components[u]] = true;
       }
    }
-   return true;
+   for(int x=0; x+1<c; ++x){
+      if(!linked[x])
+         return false;
+   }
+
+   if(n <= held_karp_max_vertices)
+      return held_karp_hamiltonian_path(path, time_limit_ms, timed_out);
+   if(starts.empty()){
+      for(int v=0; v<n; ++v){
+         if(components[v] == 0)
+            starts.push_back(v);
+      }
+   }
+   return backtracking_hamiltonian_path(components, c, starts, path,
+                                        time_limit_ms, timed_out);
 }
 
+bool Graph::held_karp_hamiltonian_path(std::list<int>& path, int time_limit_ms,
+                                       bool& timed_out) const {
+   std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+   int n = vertex_count();
+   //pred[v] = vertices with an edge to v
+   std::vector<uint32_t> pred(n,0);
+   std::list<int> adj_v;
+   for(int v=0; v<n; ++v){
+      adj_v.clear();
+      connected_from(v,adj_v);
+      for(int u: adj_v){
+         if(u != v)
+            pred[v] |= uint32_t(1) << u;
+      }
+   }
 
-bool Graph::directed_hamiltonian_path(std::list<int>& path) const {
-   for(int i=0; i<vertex_count(); ++i){
-      bool discovered[vertex_count()];
-      for(int j=0; j< vertex_count(); ++j){
-         discovered[j] = false;
+   //ends[mask] = vertices v such that some path visits exactly the
+   //vertices in mask and ends at v
+   uint32_t full = (uint32_t(1) << n) - 1;
+   std::vector<uint32_t> ends(size_t(1) << n, 0);
+
+   //masks with the same high bits form a block that only depends on
+   //itself and blocks with a subset of its high bits, so blocks with
+   //the same number of high bits are computed in parallel
+   int high_bits = std::min(n, 8);
+   int low_bits = n - high_bits;
+   for(int layer=0; layer<=high_bits; ++layer){
+      std::vector<uint32_t> blocks;
+      for(uint32_t h=0; h < (uint32_t(1) << high_bits); ++h){
+         if(__builtin_popcount(h) == layer)
+            blocks.push_back(h);
       }
-      path.push_back(i);
-      discovered[i] = true;
-      if(directed_hamiltonian_rec(i,path,discovered)){
-         return true;
+      parallel_for(blocks.size(), [&](int first, int last){
+         for(int b=first; b<last; ++b){
+            uint32_t base = blocks[b] << low_bits;
+            for(uint32_t mask = base; mask < base + (uint32_t(1) << low_bits); ++mask){
+               if((mask & (mask - 1)) == 0){
+                  ends[mask] = mask;
+                  continue;
+               }
+               uint32_t found = 0;
+               for(uint32_t bits = mask; bits; bits &= bits - 1){
+                  int v = __builtin_ctz(bits);
+                  if(ends[mask ^ (uint32_t(1) << v)] & pred[v])
+                     found |= uint32_t(1) << v;
+               }
+               ends[mask] = found;
+            }
+         }
+      });
+      std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - start;
+      if(time_limit_ms >= 0 && layer < high_bits &&
+         std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() > time_limit_ms){
+         timed_out = true;
+         return false;
       }
-      path.clear();
    }
+   if(ends[full] == 0)
+      return false;
 
-   return false;
+   //walk back through the table
+   uint32_t mask = full;
+   int v = __builtin_ctz(ends[full]);
+   path.push_front(v);
+   while(mask != (uint32_t(1) << v)){
+      mask ^= uint32_t(1) << v;
+      v = __builtin_ctz(ends[mask] & pred[v]);
+      path.push_front(v);
+   }
+   return true;
 }
 
-bool Graph::directed_hamiltonian_rec(int v, std::list<int>& path, bool discovered[]) const {
-   if(path.size() == vertex_count()){
-      return true;
+bool Graph::backtracking_hamiltonian_path(const std::vector<int>& components, int c,
+                                          const std::vector<int>& starts,
+                                          std::list<int>& path, int time_limit_ms,
+                                          bool& timed_out) const {
+   std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+   int n = vertex_count();
+   std::vector<int> offsets;
+   std::vector<int> targets;
+   flat_adjacency(OUT_EDGES, offsets, targets);
+   std::vector<int> remaining(c,0);
+   for(int v=0; v<n; ++v){
+      ++remaining[components[v]];
    }
-   //directed = connected_to
-   std::list<int> adj_v;
-   connected_to(v, adj_v);
-   if(adj_v.size()>0)
-      adj_v.sort();
-   for(int u: adj_v){
-      if(discovered[u]==false){
-         path.push_back(u);
-         discovered[u] = true;
-         if(directed_hamiltonian_rec(u,path,discovered)){
+   std::vector<bool> discovered(n,false);
+   std::vector<int> call_v;
+   std::vector<int> call_edge;
+   long steps = 0;
+
+   for(int s: starts){
+      call_v.push_back(s);
+      call_edge.push_back(offsets[s]);
+      discovered[s] = true;
+      --remaining[components[s]];
+      while(!call_v.empty()){
+         if((int)call_v.size() == n){
+            path.insert(path.end(), call_v.begin(), call_v.end());
             return true;
          }
-         path.pop_back();
-         discovered[u]=false;
+         if(time_limit_ms >= 0 && ++steps % 4096 == 0){
+            std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - start;
+            if(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() > time_limit_ms){
+               timed_out = true;
+               return false;
+            }
+         }
+         int v = call_v.back();
+         //stay in v's component until all of it is visited, then move
+         //on to the next component
+         int next_component = remaining[components[v]] > 0 ? components[v]
+                                                            : components[v] + 1;
+         int k = call_edge.back();
+         while(k < offsets[v+1] && (discovered[targets[k]] ||
+                                    components[targets[k]] != next_component)){
+            ++k;
+         }
+         if(k < offsets[v+1]){
+            int w = targets[k];
+            call_edge.back() = k + 1;
+            call_v.push_back(w);
+            call_edge.push_back(offsets[w]);
+            discovered[w] = true;
+            --remaining[components[w]];
+         } else {
+            call_v.pop_back();
+            call_edge.pop_back();
+            discovered[v] = false;
+            ++remaining[components[v]];
+         }
       }
    }
    return false;
@@ -548,175 +734,1511 @@ bool Graph::bipartite_graph_matching(Graph& max_matched_graph) const {
    if(!bipartite_graph(coloring)){
       return false;
    }
-   //separate into v1 and v2
-   Set v1;
-   Set v2;
-   Map labels;
-   bool free[vertex_count()];
-   int mates[vertex_count()];
-
+   std::vector<int> offsets;
+   std::vector<int> targets;
+   flat_adjacency(ALL_EDGES, offsets, targets);
+   //searches start from the color 0 side
+   std::vector<int> v1;
    for(int i=0; i<vertex_count(); ++i){
-      if(coloring[i]==0){
-         v1.insert(i);
-      } else {
-         v2.insert(i);
+      if(coloring[i] == 0)
+         v1.push_back(i);
+   }
+   std::vector<int> mates;
+   hopcroft_karp(v1, offsets, targets, mates);
+   for(int u: v1){
+      if(mates[u] != -1)
+         max_matched_graph.set_edge(u,0,mates[u]);
+   }
+   return true;
+}
+
+int Graph::hopcroft_karp(const std::vector<int>& v1, const std::vector<int>& offsets,
+                         const std::vector<int>& targets, std::vector<int>& mates) const {
+   int n = vertex_count();
+   const int inf = std::numeric_limits<int>::max();
+   mates.assign(n,-1);
+   std::vector<int> dist(n,inf);
+   std::vector<int> cursor(n,0);
+   std::vector<int> q;
+   std::vector<int> s;
+   int matched = 0;
+   while(true){
+      //bfs layers from the free v1 vertices through matched edges
+      q.clear();
+      for(int u: v1){
+         if(mates[u] == -1){
+            dist[u] = 0;
+            q.push_back(u);
+         } else {
+            dist[u] = inf;
+         }
+      }
+      //stop at the first layer that reaches a free vertex, so every
+      //augmenting path in the phase is a shortest one
+      int shortest = inf;
+      for(int i=0; i<(int)q.size() && dist[q[i]] + 1 < shortest; ++i){
+         int u = q[i];
+         for(int k=offsets[u]; k<offsets[u+1]; ++k){
+            int w = mates[targets[k]];
+            if(w == -1){
+               shortest = dist[u] + 1;
+            } else if(dist[w] == inf){
+               dist[w] = dist[u] + 1;
+               q.push_back(w);
+            }
+         }
       }
-      free[i] = true;
-      mates[i] = -1;
-   }   
+      if(shortest == inf)
+         break;
 
-   std::queue<int> q;
-   for(int i: v1){
-      q.push(i);
+      //dfs along the layers for vertex-disjoint augmenting paths
+      for(int u: v1){
+         cursor[u] = offsets[u];
+      }
+      for(int root: v1){
+         if(mates[root] != -1)
+            continue;
+         s.assign(1,root);
+         while(!s.empty()){
+            int u = s.back();
+            if(cursor[u] == offsets[u+1]){
+               //dead end for this phase
+               dist[u] = inf;
+               s.pop_back();
+               continue;
+            }
+            int v = targets[cursor[u]];
+            int w = mates[v];
+            if(w == -1 && dist[u] + 1 == shortest){
+               //augment: each u on the stack takes its current v
+               for(int x: s){
+                  int y = targets[cursor[x]];
+                  mates[x] = y;
+                  mates[y] = x;
+               }
+               ++matched;
+               break;
+            } else if(w != -1 && dist[w] == dist[u] + 1){
+               s.push_back(w);
+            } else {
+               ++cursor[u];
+            }
+         }
+      }
    }
+   return matched;
+}
 
-   while(!q.empty()){
-      int w = q.front();
-      q.pop();
-      // w in V (v1)
-      if(v1.find(w) != v1.end()){
-         std::list<int> adj_v;
-         adjacent(w,adj_v);
-         for(int u: adj_v){
-            if(v2.find(u) != v2.end()){
-               if(free[u]){ //augment
-                  max_matched_graph.set_edge(w,0,u);
-                  free[w] = false;
-                  mates[w] = u;
-                  free[u] = false;
-                  mates[u] = w;
-                  int v = w;
-                  while(labels.count(v)>0){
-                     u = labels[v];
-                     max_matched_graph.remove_edge(v,u);
-                     free[v] = true;
-                     mates[v] = -1;
-                     free[u] = true;
-                     mates[u] = -1;
-                     v = labels[u];
-                     max_matched_graph.set_edge(v,0,u);
-                     free[v] = false;
-                     mates[v] = u;
-                     free[u] = false;
-                     mates[u] = v;
-                  }
-                  //start over
-                  labels.clear();
-                  while(!q.empty()){
-                     q.pop();
-                  }
-                  for(int i: v1){
-                     if(free[i])
-                        q.push(i);
-                  }
-                  break;
-               } else { //u is matched
-                  if(!max_matched_graph.has_edge(w,u) && labels.count(u)==0){
-                     labels[u] = w;
-                     q.push(u);
+bool Graph::min_cost_bipartite_assignment(Graph& assignment, long long& cost) const {
+   Map coloring;
+   if(!bipartite_graph(coloring)){
+      return false;
+   }
+   int n = vertex_count();
+   std::vector<int> offsets;
+   std::vector<int> targets;
+   flat_adjacency(ALL_EDGES, offsets, targets);
+   std::vector<int> persons;
+   for(int i=0; i<n; ++i){
+      if(coloring[i] == 0)
+         persons.push_back(i);
+   }
+   //the auction only terminates if every person can be assigned
+   std::vector<int> mates;
+   if(2 * (int)persons.size() != n ||
+      hopcroft_karp(persons, offsets, targets, mates) != (int)persons.size())
+      return false;
+
+   //benefits are negated costs scaled so that a final epsilon of 1
+   //gives an optimal assignment
+   long long scale = persons.size() + 1;
+   std::vector<long long> benefit(targets.size());
+   long long max_benefit = std::numeric_limits<long long>::min();
+   long long min_benefit = std::numeric_limits<long long>::max();
+   for(int u: persons){
+      for(int k=offsets[u]; k<offsets[u+1]; ++k){
+         int edge;
+         if(!get_edge(u,targets[k],edge))
+            get_edge(targets[k],u,edge);
+         benefit[k] = -(long long)edge * scale;
+         max_benefit = std::max(max_benefit, benefit[k]);
+         min_benefit = std::min(min_benefit, benefit[k]);
+      }
+   }
+   long long spread = persons.empty() ? 0 : max_benefit - min_benefit;
+
+   std::vector<long long> price(n,0);
+   std::vector<int> owner(n,-1);
+   std::vector<int> assigned(n,-1);
+   std::vector<int> unassigned;
+   std::vector<int> bid_object;
+   std::vector<long long> bid_price;
+   std::vector<long long> best_bid(n);
+   std::vector<int> best_bidder(n,-1);
+   long long eps = std::max(1LL, spread / 4);
+   while(true){
+      std::fill(owner.begin(), owner.end(), -1);
+      std::fill(assigned.begin(), assigned.end(), -1);
+      unassigned = persons;
+      while(!unassigned.empty()){
+         //each unassigned person bids on its best object (in parallel)
+         int m = unassigned.size();
+         bid_object.assign(m,-1);
+         bid_price.assign(m,0);
+         parallel_for(m, [&](int start, int end){
+            for(int i=start; i<end; ++i){
+               int u = unassigned[i];
+               int best = -1;
+               long long first = std::numeric_limits<long long>::min();
+               long long second = std::numeric_limits<long long>::min();
+               for(int k=offsets[u]; k<offsets[u+1]; ++k){
+                  long long value = benefit[k] - price[targets[k]];
+                  if(value > first){
+                     second = first;
+                     first = value;
+                     best = targets[k];
+                  } else if(value > second){
+                     second = value;
                   }
                }
+               if(second == std::numeric_limits<long long>::min())
+                  second = first - spread;
+               bid_object[i] = best;
+               bid_price[i] = price[best] + first - second + eps;
+            }
+         });
+
+         //highest bid wins each object, displacing its previous owner
+         std::vector<int> won;
+         for(int i=0; i<m; ++i){
+            int j = bid_object[i];
+            if(best_bidder[j] == -1){
+               won.push_back(j);
+               best_bidder[j] = unassigned[i];
+               best_bid[j] = bid_price[i];
+            } else if(bid_price[i] > best_bid[j]){
+               best_bidder[j] = unassigned[i];
+               best_bid[j] = bid_price[i];
+            }
+         }
+         std::vector<int> next;
+         for(int i=0; i<m; ++i){
+            if(best_bidder[bid_object[i]] != unassigned[i])
+               next.push_back(unassigned[i]);
+         }
+         for(int j: won){
+            if(owner[j] != -1){
+               assigned[owner[j]] = -1;
+               next.push_back(owner[j]);
             }
+            owner[j] = best_bidder[j];
+            assigned[owner[j]] = j;
+            price[j] = best_bid[j];
+            best_bidder[j] = -1;
          }
-      } else { // w in U (v2)
-         int v = mates[w];
-         mates[v] = w;
-         labels[v] = w;
-         q.push(v);
+         unassigned.swap(next);
       }
+      if(eps == 1)
+         break;
+      eps = std::max(1LL, eps / 4);
    }
 
-
+   cost = 0;
+   for(int u: persons){
+      int edge;
+      if(!get_edge(u,assigned[u],edge))
+         get_edge(assigned[u],u,edge);
+      assignment.set_edge(u,edge,assigned[u]);
+      cost += edge;
+   }
    return true;
 }
 
 void Graph::cliques(std::list<Set>& cliques) const {
-   Set p;
-   Set r;
-   Set x;
-   for(int i=0; i<vertex_count(); ++i){
-      p.insert(i);
+   int n = vertex_count();
+   std::vector<int> offsets;
+   std::vector<int> targets;
+   simple_adjacency(offsets, targets);
+   std::vector<int> order;
+   std::vector<int> core;
+   degeneracy_order(offsets, targets, order, core);
+   std::vector<int> position(n);
+   for(int i=0; i<n; ++i){
+      position[order[i]] = i;
+   }
+
+   //cliques whose earliest vertex (in the ordering) is order[i]
+   std::vector<std::list<Set>> found(n);
+   parallel_for_each(n, [&](int i){
+      int v = order[i];
+      std::vector<int> r(1,v);
+      std::vector<int> p;
+      std::vector<int> x;
+      for(int k=offsets[v]; k<offsets[v+1]; ++k){
+         if(position[targets[k]] > i)
+            p.push_back(targets[k]);
+         else
+            x.push_back(targets[k]);
+      }
+      cliques_rec(r, p, x, offsets, targets, [&](const std::vector<int>& clique){
+         found[i].push_back(Set(clique.begin(), clique.end()));
+      });
+   });
+   for(int i=0; i<n; ++i){
+      cliques.splice(cliques.end(), found[i]);
    }
-   cliques_rec(p,r,x,cliques);
 }
 
-void Graph::cliques_rec(Set& p, Set& r, Set& x, std::list<Set>& cliques) const {
-   if(p.empty() && x.empty()){
-      cliques.push_back(r);
+void Graph::cliques_rec(std::vector<int>& r, std::vector<int>& p, std::vector<int>& x,
+                        const std::vector<int>& offsets, const std::vector<int>& targets,
+                        const std::function<void(const std::vector<int>&)>& emit,
+                        int min_size) const {
+   if(p.empty()){
+      if(x.empty() && (int)r.size() >= min_size)
+         emit(r);
       return;
    }
-   if(p.empty()){
+   //every clique found from here has at most |r|+|p| vertices
+   if((int)(r.size() + p.size()) < min_size)
       return;
+
+   //pivot on the vertex of p or x with the most neighbors in p
+   int pivot = -1;
+   int most = -1;
+   for(int pass=0; pass<2; ++pass){
+      for(int u: (pass == 0 ? p : x)){
+         const int* a = p.data();
+         const int* a_end = a + p.size();
+         const int* b = targets.data() + offsets[u];
+         const int* b_end = targets.data() + offsets[u+1];
+         int count = 0;
+         while(a != a_end && b != b_end){
+            if(*a < *b)
+               ++a;
+            else if(*b < *a)
+               ++b;
+            else {
+               ++count;
+               ++a;
+               ++b;
+            }
+         }
+         if(count > most){
+            most = count;
+            pivot = u;
+         }
+      }
    }
-   
-   while(!p.empty()){
-      int v = *p.begin();
-      std::list<int> adj_v;
-      adjacent(v,adj_v);
-      std::list<int> temp;
-      Set adj(adj_v.begin(),adj_v.end());
+
+   //only p vertices that are not neighbors of the pivot need branches
+   std::vector<int> candidates;
+   std::set_difference(p.begin(), p.end(),
+                       targets.begin() + offsets[pivot], targets.begin() + offsets[pivot+1],
+                       std::back_inserter(candidates));
+   for(int v: candidates){
+      std::vector<int>::const_iterator adj_begin = targets.begin() + offsets[v];
+      std::vector<int>::const_iterator adj_end = targets.begin() + offsets[v+1];
       //p intersect with adj(v)
-      std::set_intersection(p.begin(),p.end(),adj.begin(),adj.end(),std::back_inserter(temp));
-      Set p_new(temp.begin(),temp.end());
-      //p = p_new;
-      //r union with v
-      r.insert(v);
+      std::vector<int> p_new;
+      std::set_intersection(p.begin(), p.end(), adj_begin, adj_end, std::back_inserter(p_new));
       //x intersect with adj(v)
-      std::set_intersection(x.begin(),x.end(),adj.begin(),adj.end(),std::back_inserter(temp));
-      Set x_new(temp.begin(),temp.end());
-      //x = x_new;
-      
-      cliques_rec(p_new,r,x_new,cliques);
-      r.erase(v);
-      p.erase(v);
-      x.insert(v);
-      
+      std::vector<int> x_new;
+      std::set_intersection(x.begin(), x.end(), adj_begin, adj_end, std::back_inserter(x_new));
+      r.push_back(v);
+      cliques_rec(r, p_new, x_new, offsets, targets, emit, min_size);
+      r.pop_back();
+      //move v from p to x
+      p.erase(std::lower_bound(p.begin(), p.end(), v));
+      x.insert(std::upper_bound(x.begin(), x.end(), v), v);
    }
-
-   
-   return;
 }
 
-//use get_edge(v1,v2,edge) to get edge label/weight
-void Graph::dijkstra_shortest_path(int src, Map& path_costs) const {
-   Set x;
-   Set not_x;
-   for(int i=0; i<vertex_count(); ++i){
-      not_x.insert(i);
+void Graph::cliques(int min_size, const std::function<void(const Set&)>& sink) const {
+   int n = vertex_count();
+   std::vector<int> offsets;
+   std::vector<int> targets;
+   simple_adjacency(offsets, targets);
+   std::vector<int> order;
+   std::vector<int> core;
+   degeneracy_order(offsets, targets, order, core);
+   std::vector<int> position(n);
+   for(int i=0; i<n; ++i){
+      position[order[i]] = i;
    }
-   not_x.erase(src);
-   x.insert(src);
 
-   for(int i=0; i<vertex_count();++i){
-      path_costs[i] = std::numeric_limits<int>::max();
-   }
-   path_costs[src] = 0;
+   std::mutex sink_lock;
+   parallel_for_each(n, [&](int i){
+      int v = order[i];
+      //a clique containing v has at most core[v]+1 vertices
+      if(core[v] + 1 < min_size)
+         return;
+      std::vector<int> r(1,v);
+      std::vector<int> p;
+      std::vector<int> x;
+      for(int k=offsets[v]; k<offsets[v+1]; ++k){
+         if(position[targets[k]] > i)
+            p.push_back(targets[k]);
+         else
+            x.push_back(targets[k]);
+      }
+      cliques_rec(r, p, x, offsets, targets, [&](const std::vector<int>& clique){
+         Set found(clique.begin(), clique.end());
+         std::lock_guard<std::mutex> guard(sink_lock);
+         sink(found);
+      }, min_size);
+   });
+}
 
-   while(x.size()<vertex_count()){
-      int min_vertex = -1;
-      int min_value = std::numeric_limits<int>::max();
-      for(std::set<int>::iterator u = x.begin(); u!=x.end(); ++u){
-         std::list<int> adj_v;
-         connected_to(*u,adj_v);
-         for(int v: adj_v){
-            //if v is not in x
-            if(not_x.find(v) != not_x.end()){
-               if(path_costs[v]==std::numeric_limits<int>::max()){
-                  int edge;
-                  get_edge(*u,v,edge);
-                  if(path_costs[*u] + edge < min_value){
-                     min_value = path_costs[*u] + edge;
-                     min_vertex = v;
-                  }
-               }
+void Graph::maximum_clique(Set& clique) const {
+   int n = vertex_count();
+   std::vector<int> offsets;
+   std::vector<int> targets;
+   simple_adjacency(offsets, targets);
+   std::vector<int> order;
+   std::vector<int> core;
+   degeneracy_order(offsets, targets, order, core);
+   //high-core vertices first, so good cliques are found early
+   std::vector<int> p(order.rbegin(), order.rend());
+   std::vector<int> r;
+   std::vector<int> best;
+   if(n > 0)
+      best.push_back(p.front());
+   maximum_clique_rec(r, p, offsets, targets, best);
+   clique.insert(best.begin(), best.end());
+}
+
+void Graph::maximum_clique_rec(std::vector<int>& r, const std::vector<int>& p,
+                               const std::vector<int>& offsets,
+                               const std::vector<int>& targets,
+                               std::vector<int>& best) const {
+   std::vector<int>::const_iterator all = targets.begin();
+   //greedy coloring: color[i] bounds the clique size among p[0..i]
+   std::vector<std::vector<int>> classes;
+   for(int v: p){
+      int k = 0;
+      for(; k<(int)classes.size(); ++k){
+         bool conflict = false;
+         for(int u: classes[k]){
+            if(std::binary_search(all + offsets[v], all + offsets[v+1], u)){
+               conflict = true;
+               break;
             }
          }
+         if(!conflict)
+            break;
       }
-      x.insert(min_vertex);
-      not_x.erase(min_vertex);
-      path_costs[min_vertex] = min_value;
+      if(k == (int)classes.size())
+         classes.push_back(std::vector<int>());
+      classes[k].push_back(v);
    }
-}
+   std::vector<int> sorted;
+   std::vector<int> color;
+   for(int k=0; k<(int)classes.size(); ++k){
+      for(int v: classes[k]){
+         sorted.push_back(v);
+         color.push_back(k + 1);
+      }
+   }
+
+   //branch on the highest colors first, later branches only use the
+   //vertices before them
+   for(int i=sorted.size()-1; i>=0; --i){
+      if(r.size() + color[i] <= best.size())
+         return;
+      int v = sorted[i];
+      std::vector<int> p_new;
+      for(int j=0; j<i; ++j){
+         if(std::binary_search(all + offsets[v], all + offsets[v+1], sorted[j]))
+            p_new.push_back(sorted[j]);
+      }
+      r.push_back(v);
+      if(p_new.empty()){
+         if(r.size() > best.size())
+            best = r;
+      } else {
+         maximum_clique_rec(r, p_new, offsets, targets, best);
+      }
+      r.pop_back();
+   }
+}
+
+long long Graph::triangle_count() const {
+   std::vector<long long> triangles;
+   return triangle_count(triangles);
+}
+
+long long Graph::triangle_count(std::vector<long long>& triangles) const {
+   int n = vertex_count();
+   std::vector<int> offsets;
+   std::vector<int> targets;
+   simple_adjacency(offsets, targets);
+   //orient each edge towards the higher (degree, vertex) endpoint,
+   //which leaves every out-list sorted and short
+   std::vector<int> out_offsets(n+1, 0);
+   std::vector<int> out_targets;
+   out_targets.reserve(targets.size() / 2);
+   for(int u=0; u<n; ++u){
+      int du = offsets[u+1] - offsets[u];
+      for(int k=offsets[u]; k<offsets[u+1]; ++k){
+         int v = targets[k];
+         int dv = offsets[v+1] - offsets[v];
+         if(du < dv || (du == dv && u < v))
+            out_targets.push_back(v);
+      }
+      out_offsets[u+1] = out_targets.size();
+   }
+
+   std::vector<std::atomic<long long>> counts(n);
+   for(int v=0; v<n; ++v){
+      counts[v].store(0);
+   }
+   parallel_for_each(n, [&](int u){
+      const int* u_out = out_targets.data() + out_offsets[u];
+      int u_size = out_offsets[u+1] - out_offsets[u];
+      std::vector<int> common(u_size);
+      long long found = 0;
+      for(int i=0; i<u_size; ++i){
+         int v = u_out[i];
+         const int* v_out = out_targets.data() + out_offsets[v];
+         int v_size = out_offsets[v+1] - out_offsets[v];
+         //one pass finds the third vertices of the triangles on u-v
+         int count = sorted_intersection(u_out, u_size, v_out, v_size, common.data());
+         if(count == 0)
+            continue;
+         found += count;
+         counts[v].fetch_add(count, std::memory_order_relaxed);
+         for(int j=0; j<count; ++j){
+            counts[common[j]].fetch_add(1, std::memory_order_relaxed);
+         }
+      }
+      counts[u].fetch_add(found, std::memory_order_relaxed);
+   });
+
+   triangles.resize(n);
+   long long total = 0;
+   for(int v=0; v<n; ++v){
+      triangles[v] = counts[v].load();
+      total += triangles[v];
+   }
+   return total / 3;
+}
+
+void Graph::local_clustering_coefficients(std::vector<double>& coefficients) const {
+   std::vector<long long> triangles;
+   triangle_count(triangles);
+   std::vector<int> offsets;
+   std::vector<int> targets;
+   simple_adjacency(offsets, targets);
+   int n = vertex_count();
+   coefficients.assign(n, 0.0);
+   for(int v=0; v<n; ++v){
+      long long d = offsets[v+1] - offsets[v];
+      if(d >= 2)
+         coefficients[v] = 2.0 * triangles[v] / (d * (d-1));
+   }
+}
+
+double Graph::transitivity() const {
+   long long triangles = triangle_count();
+   std::vector<int> offsets;
+   std::vector<int> targets;
+   simple_adjacency(offsets, targets);
+   long long triples = 0;
+   for(int v=0; v<vertex_count(); ++v){
+      long long d = offsets[v+1] - offsets[v];
+      triples += d * (d-1) / 2;
+   }
+   if(triples == 0)
+      return 0.0;
+   return 3.0 * triangles / triples;
+}
+
+int Graph::sorted_intersection(const int* a, int a_size, const int* b, int b_size,
+                               int* common) {
+   if(a_size > b_size){
+      std::swap(a, b);
+      std::swap(a_size, b_size);
+   }
+   int count = 0;
+   if((long long)a_size * 32 < b_size){
+      //binary search each element of the short range in what is left
+      //of the long one
+      const int* end = b + b_size;
+      for(int i=0; i<a_size && b<end; ++i){
+         b = std::lower_bound(b, end, a[i]);
+         if(b < end && *b == a[i]){
+            common[count++] = a[i];
+            ++b;
+         }
+      }
+      return count;
+   }
+   //branch-free merge, each element is written and only kept on a match
+   int i = 0;
+   int j = 0;
+   while(i < a_size && j < b_size){
+      int x = a[i];
+      int y = b[j];
+      common[count] = x;
+      count += (x == y);
+      i += (x <= y);
+      j += (y <= x);
+   }
+   return count;
+}
+
+int Graph::core_decomposition(std::vector<int>& core) const {
+   std::vector<int> order;
+   return core_decomposition(core, order);
+}
+
+int Graph::core_decomposition(std::vector<int>& core, std::vector<int>& order) const {
+   std::vector<int> offsets;
+   std::vector<int> targets;
+   simple_adjacency(offsets, targets);
+   degeneracy_order(offsets, targets, order, core);
+   int degeneracy = 0;
+   for(int k: core){
+      degeneracy = std::max(degeneracy, k);
+   }
+   return degeneracy;
+}
+
+int Graph::parallel_core_decomposition(std::vector<int>& core) const {
+   int n = vertex_count();
+   std::vector<int> offsets;
+   std::vector<int> targets;
+   simple_adjacency(offsets, targets);
+   std::vector<std::atomic<int>> degree(n);
+   for(int v=0; v<n; ++v){
+      degree[v].store(offsets[v+1] - offsets[v]);
+   }
+   core.assign(n,0);
+   std::vector<char> removed(n,0);
+   std::vector<int> frontier;
+   std::vector<int> next;
+   std::mutex next_lock;
+   int remaining = n;
+   int k = 0;
+   while(remaining > 0){
+      frontier.clear();
+      for(int v=0; v<n; ++v){
+         if(!removed[v] && degree[v].load() <= k)
+            frontier.push_back(v);
+      }
+      //peel rounds at level k until no vertex drops to k
+      while(!frontier.empty()){
+         for(int v: frontier){
+            removed[v] = 1;
+            core[v] = k;
+         }
+         remaining -= frontier.size();
+         next.clear();
+         parallel_for(frontier.size(), [&](int start, int end){
+            std::vector<int> dropped;
+            for(int i=start; i<end; ++i){
+               int v = frontier[i];
+               for(int e=offsets[v]; e<offsets[v+1]; ++e){
+                  int u = targets[e];
+                  //only the decrement from k+1 to k queues u
+                  if(!removed[u] && degree[u].fetch_sub(1) == k+1)
+                     dropped.push_back(u);
+               }
+            }
+            std::lock_guard<std::mutex> guard(next_lock);
+            next.insert(next.end(), dropped.begin(), dropped.end());
+         });
+         frontier.swap(next);
+      }
+      ++k;
+   }
+   int degeneracy = 0;
+   for(int c: core){
+      degeneracy = std::max(degeneracy, c);
+   }
+   return degeneracy;
+}
+
+int Graph::k_core(int k, Graph& core_graph) const {
+   std::vector<int> core;
+   core_decomposition(core);
+   int size = 0;
+   std::list<int> adj_v;
+   for(int u=0; u<vertex_count(); ++u){
+      if(core[u] < k)
+         continue;
+      ++size;
+      adj_v.clear();
+      connected_to(u,adj_v);
+      for(int v: adj_v){
+         int edge;
+         if(core[v] >= k && get_edge(u,v,edge))
+            core_graph.set_edge(u,edge,v);
+      }
+   }
+   return size;
+}
+
+long long Graph::max_flow(int src, int dst, Graph& flow, Set& source_side) const {
+   int n = vertex_count();
+   std::vector<int> offsets;
+   std::vector<int> heads;
+   std::vector<int> reverse;
+   std::vector<long long> residual;
+   std::vector<int> edge_arcs;
+   flow_network(offsets, heads, reverse, residual, edge_arcs);
+   if(src == dst){
+      flow_result(src, offsets, heads, reverse, residual, edge_arcs, flow, source_side);
+      return 0;
+   }
+   int arcs = heads.size();
+   std::vector<int> height(n, 0);
+   std::vector<long long> excess(n, 0);
+   std::vector<int> current(offsets.begin(), offsets.end() - 1);
+   //active[h] holds vertices with excess at height h (checked when
+   //popped), and each height below n keeps a linked list of all its
+   //vertices for the gap heuristic
+   std::vector<std::vector<int>> active(n);
+   std::vector<int> first(n, -1);
+   std::vector<int> next(n, -1);
+   std::vector<int> prev(n, -1);
+   std::vector<int> queue;
+   queue.reserve(n);
+   int highest = 0;
+   int highest_label = 0;
+
+   auto link = [&](int v){
+      int h = height[v];
+      prev[v] = -1;
+      next[v] = first[h];
+      if(first[h] != -1)
+         prev[first[h]] = v;
+      first[h] = v;
+      highest_label = std::max(highest_label, h);
+   };
+   auto unlink = [&](int v){
+      if(prev[v] != -1)
+         next[prev[v]] = next[v];
+      else
+         first[height[v]] = next[v];
+      if(next[v] != -1)
+         prev[next[v]] = prev[v];
+   };
+   auto activate = [&](int v){
+      active[height[v]].push_back(v);
+      highest = std::max(highest, height[v]);
+   };
+   //exact distances to dst in the residual graph (n if unreachable)
+   auto global_relabel = [&](){
+      std::fill(height.begin(), height.end(), n);
+      for(int h=0; h<n; ++h){
+         active[h].clear();
+         first[h] = -1;
+      }
+      highest = 0;
+      highest_label = 0;
+      height[dst] = 0;
+      queue.assign(1, dst);
+      for(int i=0; i<(int)queue.size(); ++i){
+         int v = queue[i];
+         for(int a=offsets[v]; a<offsets[v+1]; ++a){
+            int u = heads[a];
+            if(u != src && height[u] == n && residual[reverse[a]] > 0){
+               height[u] = height[v] + 1;
+               queue.push_back(u);
+            }
+         }
+      }
+      for(int v: queue){
+         link(v);
+         current[v] = offsets[v];
+         if(excess[v] > 0 && v != dst)
+            activate(v);
+      }
+   };
+
+   //saturate the source's arcs
+   for(int a=offsets[src]; a<offsets[src+1]; ++a){
+      long long c = residual[a];
+      residual[a] = 0;
+      residual[reverse[a]] += c;
+      excess[heads[a]] += c;
+      excess[src] -= c;
+   }
+   global_relabel();
+
+   //phase one: discharge the highest active vertex below n
+   long long work = 0;
+   long long relabel_period = 6LL*n + arcs;
+   while(true){
+      while(highest > 0 && active[highest].empty()){
+         --highest;
+      }
+      if(active[highest].empty())
+         break;
+      int u = active[highest].back();
+      active[highest].pop_back();
+      if(height[u] != highest || excess[u] == 0)
+         continue;
+      while(excess[u] > 0){
+         if(current[u] == offsets[u+1]){
+            //relabel to one above the lowest residual neighbor
+            int old = height[u];
+            int lowest = 2*n;
+            for(int a=offsets[u]; a<offsets[u+1]; ++a){
+               if(residual[a] > 0)
+                  lowest = std::min(lowest, height[heads[a]] + 1);
+            }
+            work += offsets[u+1] - offsets[u] + 12;
+            unlink(u);
+            if(first[old] == -1){
+               //gap: nothing above old can reach dst any more
+               for(int h=old+1; h<=highest_label; ++h){
+                  for(int v=first[h]; v!=-1; v=next[v]){
+                     height[v] = n;
+                  }
+                  first[h] = -1;
+               }
+               highest_label = old - 1;
+               height[u] = n;
+               break;
+            }
+            height[u] = std::min(lowest, n);
+            if(height[u] >= n)
+               break;
+            link(u);
+            current[u] = offsets[u];
+            continue;
+         }
+         int a = current[u];
+         int v = heads[a];
+         if(residual[a] > 0 && height[u] == height[v] + 1){
+            long long delta = std::min(excess[u], residual[a]);
+            if(excess[v] == 0 && v != dst)
+               activate(v);
+            residual[a] -= delta;
+            residual[reverse[a]] += delta;
+            excess[u] -= delta;
+            excess[v] += delta;
+         } else {
+            ++current[u];
+         }
+      }
+      if(excess[u] > 0 && height[u] < n)
+         activate(u);
+      if(work > relabel_period){
+         global_relabel();
+         work = 0;
+      }
+   }
+   long long value = excess[dst];
+
+   //phase two: return the remaining excess, labeling by distance to src
+   std::fill(height.begin(), height.end(), 2*n);
+   height[src] = n;
+   queue.assign(1, src);
+   for(int i=0; i<(int)queue.size(); ++i){
+      int v = queue[i];
+      for(int a=offsets[v]; a<offsets[v+1]; ++a){
+         int u = heads[a];
+         if(u != dst && height[u] == 2*n && residual[reverse[a]] > 0){
+            height[u] = height[v] + 1;
+            queue.push_back(u);
+         }
+      }
+   }
+   std::vector<int> fifo;
+   for(int v=0; v<n; ++v){
+      current[v] = offsets[v];
+      if(v != src && v != dst && excess[v] > 0)
+         fifo.push_back(v);
+   }
+   for(int i=0; i<(int)fifo.size(); ++i){
+      int u = fifo[i];
+      while(excess[u] > 0){
+         if(current[u] == offsets[u+1]){
+            int lowest = 4*n;
+            for(int a=offsets[u]; a<offsets[u+1]; ++a){
+               if(residual[a] > 0 && heads[a] != dst)
+                  lowest = std::min(lowest, height[heads[a]] + 1);
+            }
+            height[u] = lowest;
+            current[u] = offsets[u];
+            continue;
+         }
+         int a = current[u];
+         int v = heads[a];
+         if(v != dst && residual[a] > 0 && height[u] == height[v] + 1){
+            long long delta = std::min(excess[u], residual[a]);
+            if(excess[v] == 0 && v != src)
+               fifo.push_back(v);
+            residual[a] -= delta;
+            residual[reverse[a]] += delta;
+            excess[u] -= delta;
+            excess[v] += delta;
+         } else {
+            ++current[u];
+         }
+      }
+   }
+
+   flow_result(src, offsets, heads, reverse, residual, edge_arcs, flow, source_side);
+   return value;
+}
+
+long long Graph::edmonds_karp_max_flow(int src, int dst, Graph& flow, Set& source_side) const {
+   int n = vertex_count();
+   std::vector<int> offsets;
+   std::vector<int> heads;
+   std::vector<int> reverse;
+   std::vector<long long> residual;
+   std::vector<int> edge_arcs;
+   flow_network(offsets, heads, reverse, residual, edge_arcs);
+   long long value = 0;
+   std::vector<int> parent_arc(n);
+   std::vector<int> queue;
+   while(src != dst){
+      //shortest augmenting path by bfs
+      std::fill(parent_arc.begin(), parent_arc.end(), -1);
+      queue.assign(1, src);
+      for(int i=0; i<(int)queue.size() && parent_arc[dst] == -1; ++i){
+         int u = queue[i];
+         for(int a=offsets[u]; a<offsets[u+1]; ++a){
+            int v = heads[a];
+            if(v != src && parent_arc[v] == -1 && residual[a] > 0){
+               parent_arc[v] = a;
+               queue.push_back(v);
+            }
+         }
+      }
+      if(parent_arc[dst] == -1)
+         break;
+      long long delta = std::numeric_limits<long long>::max();
+      for(int v=dst; v!=src; v=heads[reverse[parent_arc[v]]]){
+         delta = std::min(delta, residual[parent_arc[v]]);
+      }
+      for(int v=dst; v!=src; v=heads[reverse[parent_arc[v]]]){
+         residual[parent_arc[v]] -= delta;
+         residual[reverse[parent_arc[v]]] += delta;
+      }
+      value += delta;
+   }
+   flow_result(src, offsets, heads, reverse, residual, edge_arcs, flow, source_side);
+   return value;
+}
+
+void Graph::flow_network(std::vector<int>& offsets, std::vector<int>& heads,
+                         std::vector<int>& reverse, std::vector<long long>& residual,
+                         std::vector<int>& edge_arcs) const {
+   int n = vertex_count();
+   std::vector<int> edge_offsets;
+   std::vector<int> targets;
+   flat_adjacency(OUT_EDGES, edge_offsets, targets);
+   //each edge u->v gives an arc at u and a reverse arc at v
+   offsets.assign(n+1, 0);
+   for(int u=0; u<n; ++u){
+      for(int k=edge_offsets[u]; k<edge_offsets[u+1]; ++k){
+         if(targets[k] != u){
+            ++offsets[u+1];
+            ++offsets[targets[k]+1];
+         }
+      }
+   }
+   for(int v=0; v<n; ++v){
+      offsets[v+1] += offsets[v];
+   }
+   int arcs = offsets[n];
+   heads.assign(arcs, 0);
+   reverse.assign(arcs, 0);
+   residual.assign(arcs, 0);
+   edge_arcs.assign(targets.size(), -1);
+   std::vector<int> fill(offsets.begin(), offsets.end() - 1);
+   for(int u=0; u<n; ++u){
+      for(int k=edge_offsets[u]; k<edge_offsets[u+1]; ++k){
+         int v = targets[k];
+         if(v == u)
+            continue;
+         int capacity;
+         get_edge(u,v,capacity);
+         int a = fill[u]++;
+         int b = fill[v]++;
+         heads[a] = v;
+         heads[b] = u;
+         reverse[a] = b;
+         reverse[b] = a;
+         residual[a] = std::max(capacity, 0);
+         edge_arcs[k] = a;
+      }
+   }
+}
+
+void Graph::flow_result(int src, const std::vector<int>& offsets,
+                        const std::vector<int>& heads, const std::vector<int>& reverse,
+                        const std::vector<long long>& residual,
+                        const std::vector<int>& edge_arcs, Graph& flow,
+                        Set& source_side) const {
+   int n = vertex_count();
+   std::vector<int> edge_offsets;
+   std::vector<int> targets;
+   flat_adjacency(OUT_EDGES, edge_offsets, targets);
+   for(int u=0; u<n; ++u){
+      for(int k=edge_offsets[u]; k<edge_offsets[u+1]; ++k){
+         int a = edge_arcs[k];
+         //flow on an edge is what its reverse arc can send back
+         flow.set_edge(u, a == -1 ? 0 : residual[reverse[a]], targets[k]);
+      }
+   }
+   std::vector<bool> reached(n, false);
+   std::vector<int> queue(1, src);
+   reached[src] = true;
+   for(int i=0; i<(int)queue.size(); ++i){
+      int u = queue[i];
+      source_side.insert(u);
+      for(int a=offsets[u]; a<offsets[u+1]; ++a){
+         if(residual[a] > 0 && !reached[heads[a]]){
+            reached[heads[a]] = true;
+            queue.push_back(heads[a]);
+         }
+      }
+   }
+}
+
+int Graph::louvain_communities(Map& communities, double& modularity) const {
+   std::vector<int> dense;
+   int c = louvain_communities(dense, modularity);
+   for(int v=0; v<(int)dense.size(); ++v){
+      communities[v] = dense[v];
+   }
+   return c;
+}
+
+int Graph::louvain_communities(std::vector<int>& communities, double& modularity) const {
+   int n = vertex_count();
+   std::vector<int> offsets;
+   std::vector<int> targets;
+   std::vector<double> weights;
+   std::vector<double> loops;
+   undirected_weights(offsets, targets, weights, loops);
+   //the level graph starts as the original, membership maps each
+   //original vertex to its level vertex
+   std::vector<int> level_offsets(offsets);
+   std::vector<int> level_targets(targets);
+   std::vector<double> level_weights(weights);
+   std::vector<double> level_loops(loops);
+   std::vector<int> membership(n);
+   for(int v=0; v<n; ++v){
+      membership[v] = v;
+   }
+
+   while(true){
+      int m = level_loops.size();
+      std::vector<double> degree(level_loops);
+      double total = 0;
+      for(int u=0; u<m; ++u){
+         for(int e=level_offsets[u]; e<level_offsets[u+1]; ++e){
+            degree[u] += level_weights[e];
+         }
+         total += degree[u];
+      }
+      if(total <= 0)
+         break;
+      std::vector<int> community(m);
+      std::vector<double> community_degree(degree);
+      std::vector<int> size(m, 1);
+      for(int u=0; u<m; ++u){
+         community[u] = u;
+      }
+      double quality = partition_modularity(level_offsets, level_targets, level_weights,
+                                            level_loops, community);
+
+      //best community for u given the current communities, where the
+      //gain of joining c is its link weight to c less its expected
+      //share of c's degree (u itself not counted in its own community)
+      auto best_move = [&](int u, std::vector<double>& link, std::vector<int>& touched){
+         int own = community[u];
+         touched.clear();
+         for(int e=level_offsets[u]; e<level_offsets[u+1]; ++e){
+            int c = community[level_targets[e]];
+            if(link[c] == 0)
+               touched.push_back(c);
+            link[c] += level_weights[e];
+         }
+         int best = own;
+         double best_gain = link[own] - (community_degree[own] - degree[u]) * degree[u] / total;
+         for(int c: touched){
+            double gain = link[c] - community_degree[c] * degree[u] / total;
+            //singletons only join smaller-numbered singletons, so two
+            //of them never swap places in the same round
+            if(c != own && gain > best_gain + 1e-12 &&
+               !(size[own] == 1 && size[c] == 1 && c > own)){
+               best = c;
+               best_gain = gain;
+            }
+         }
+         for(int c: touched){
+            link[c] = 0;
+         }
+         link[own] = 0;
+         return best;
+      };
+      auto recount = [&](){
+         std::fill(community_degree.begin(), community_degree.end(), 0.0);
+         std::fill(size.begin(), size.end(), 0);
+         for(int u=0; u<m; ++u){
+            community_degree[community[u]] += degree[u];
+            ++size[community[u]];
+         }
+      };
+
+      //parallel rounds while they improve modularity
+      std::vector<int> target(m);
+      while(true){
+         parallel_for(m, [&](int start, int end){
+            std::vector<double> link(m, 0.0);
+            std::vector<int> touched;
+            for(int u=start; u<end; ++u){
+               target[u] = best_move(u, link, touched);
+            }
+         });
+         if(target == community)
+            break;
+         target.swap(community);
+         recount();
+         double moved = partition_modularity(level_offsets, level_targets, level_weights,
+                                             level_loops, community);
+         if(moved <= quality + 1e-12){
+            target.swap(community);
+            recount();
+            break;
+         }
+         quality = moved;
+      }
+      //sequential rounds never lower modularity
+      std::vector<double> link(m, 0.0);
+      std::vector<int> touched;
+      bool changed = true;
+      while(changed){
+         changed = false;
+         for(int u=0; u<m; ++u){
+            int own = community[u];
+            int best = best_move(u, link, touched);
+            if(best != own){
+               community_degree[own] -= degree[u];
+               --size[own];
+               community_degree[best] += degree[u];
+               ++size[best];
+               community[u] = best;
+               changed = true;
+            }
+         }
+      }
+
+      //renumber the communities and stop once no vertex was merged
+      std::vector<int> number(m, -1);
+      int c = 0;
+      for(int u=0; u<m; ++u){
+         if(number[community[u]] == -1)
+            number[community[u]] = c++;
+         community[u] = number[community[u]];
+      }
+      if(c == m)
+         break;
+      for(int v=0; v<n; ++v){
+         membership[v] = community[membership[v]];
+      }
+
+      //aggregate: one vertex per community, summing the weights between
+      //communities and folding internal weight into the self loops
+      std::vector<int> members_offsets(c+1, 0);
+      for(int u=0; u<m; ++u){
+         ++members_offsets[community[u]+1];
+      }
+      for(int k=0; k<c; ++k){
+         members_offsets[k+1] += members_offsets[k];
+      }
+      std::vector<int> members(m);
+      std::vector<int> fill(members_offsets.begin(), members_offsets.end() - 1);
+      for(int u=0; u<m; ++u){
+         members[fill[community[u]]++] = u;
+      }
+      std::vector<std::vector<int>> next_targets(c);
+      std::vector<std::vector<double>> next_weights(c);
+      std::vector<double> next_loops(c, 0.0);
+      parallel_for(c, [&](int start, int end){
+         std::vector<double> link(c, 0.0);
+         std::vector<int> touched;
+         for(int k=start; k<end; ++k){
+            touched.clear();
+            for(int i=members_offsets[k]; i<members_offsets[k+1]; ++i){
+               int u = members[i];
+               next_loops[k] += level_loops[u];
+               for(int e=level_offsets[u]; e<level_offsets[u+1]; ++e){
+                  int d = community[level_targets[e]];
+                  if(d == k){
+                     next_loops[k] += level_weights[e];
+                  } else {
+                     if(link[d] == 0)
+                        touched.push_back(d);
+                     link[d] += level_weights[e];
+                  }
+               }
+            }
+            std::sort(touched.begin(), touched.end());
+            for(int d: touched){
+               next_targets[k].push_back(d);
+               next_weights[k].push_back(link[d]);
+               link[d] = 0;
+            }
+         }
+      });
+      level_offsets.assign(c+1, 0);
+      level_targets.clear();
+      level_weights.clear();
+      for(int k=0; k<c; ++k){
+         level_targets.insert(level_targets.end(), next_targets[k].begin(), next_targets[k].end());
+         level_weights.insert(level_weights.end(), next_weights[k].begin(), next_weights[k].end());
+         level_offsets[k+1] = level_targets.size();
+      }
+      level_loops.swap(next_loops);
+   }
+
+   //number communities by their smallest vertex
+   std::vector<int> number(n, -1);
+   int c = 0;
+   communities.resize(n);
+   for(int v=0; v<n; ++v){
+      if(number[membership[v]] == -1)
+         number[membership[v]] = c++;
+      communities[v] = number[membership[v]];
+   }
+   modularity = partition_modularity(offsets, targets, weights, loops, communities);
+   return c;
+}
+
+double Graph::modularity(const std::vector<int>& communities) const {
+   std::vector<int> offsets;
+   std::vector<int> targets;
+   std::vector<double> weights;
+   std::vector<double> loops;
+   undirected_weights(offsets, targets, weights, loops);
+   return partition_modularity(offsets, targets, weights, loops, communities);
+}
+
+void Graph::undirected_weights(std::vector<int>& offsets, std::vector<int>& targets,
+                               std::vector<double>& weights,
+                               std::vector<double>& loops) const {
+   int n = vertex_count();
+   simple_adjacency(offsets, targets);
+   weights.resize(targets.size());
+   loops.assign(n, 0.0);
+   for(int u=0; u<n; ++u){
+      int label;
+      if(get_edge(u,u,label))
+         loops[u] = 2.0 * label;
+      for(int k=offsets[u]; k<offsets[u+1]; ++k){
+         int v = targets[k];
+         int forward;
+         int backward;
+         bool has_forward = get_edge(u,v,forward);
+         bool has_backward = get_edge(v,u,backward);
+         if(!has_forward || (has_backward && backward < forward))
+            forward = backward;
+         weights[k] = forward;
+      }
+   }
+}
+
+double Graph::partition_modularity(const std::vector<int>& offsets,
+                                   const std::vector<int>& targets,
+                                   const std::vector<double>& weights,
+                                   const std::vector<double>& loops,
+                                   const std::vector<int>& communities) {
+   int n = loops.size();
+   double total = 0;
+   double internal = 0;
+   std::unordered_map<int,double> community_degree;
+   for(int u=0; u<n; ++u){
+      double degree = loops[u];
+      for(int e=offsets[u]; e<offsets[u+1]; ++e){
+         degree += weights[e];
+         if(communities[targets[e]] == communities[u])
+            internal += weights[e];
+      }
+      internal += loops[u];
+      total += degree;
+      community_degree[communities[u]] += degree;
+   }
+   if(total <= 0)
+      return 0.0;
+   double expected = 0;
+   for(const std::pair<const int,double>& c: community_degree){
+      expected += (c.second / total) * (c.second / total);
+   }
+   return internal / total - expected;
+}
+
+void Graph::degeneracy_order(const std::vector<int>& offsets, const std::vector<int>& targets,
+                             std::vector<int>& order, std::vector<int>& core) const {
+   int n = offsets.size() - 1;
+   core.assign(n,0);
+   int max_degree = 0;
+   for(int v=0; v<n; ++v){
+      core[v] = offsets[v+1] - offsets[v];
+      max_degree = std::max(max_degree, core[v]);
+   }
+   //bin[d] = first position of degree d vertices in order
+   std::vector<int> bin(max_degree + 1, 0);
+   for(int v=0; v<n; ++v){
+      ++bin[core[v]];
+   }
+   int start = 0;
+   for(int d=0; d<=max_degree; ++d){
+      int count = bin[d];
+      bin[d] = start;
+      start += count;
+   }
+   order.assign(n,0);
+   std::vector<int> position(n);
+   for(int v=0; v<n; ++v){
+      position[v] = bin[core[v]]++;
+      order[position[v]] = v;
+   }
+   for(int d=max_degree; d>0; --d){
+      bin[d] = bin[d-1];
+   }
+   bin[0] = 0;
+
+   //remove vertices in order, moving each higher-degree neighbor down
+   //one bucket by swapping it with the first vertex of its bucket
+   for(int i=0; i<n; ++i){
+      int v = order[i];
+      for(int k=offsets[v]; k<offsets[v+1]; ++k){
+         int u = targets[k];
+         if(core[u] > core[v]){
+            int du = core[u];
+            int pu = position[u];
+            int pw = bin[du];
+            int w = order[pw];
+            if(u != w){
+               position[u] = pw;
+               order[pu] = w;
+               position[w] = pu;
+               order[pw] = u;
+            }
+            ++bin[du];
+            --core[u];
+         }
+      }
+   }
+}
+
+void Graph::simple_adjacency(std::vector<int>& offsets, std::vector<int>& targets) const {
+   flat_adjacency(ALL_EDGES, offsets, targets);
+   int n = vertex_count();
+   int kept = 0;
+   int begin = 0;
+   for(int v=0; v<n; ++v){
+      for(int k=begin; k<offsets[v+1]; ++k){
+         if(targets[k] != v)
+            targets[kept++] = targets[k];
+      }
+      begin = offsets[v+1];
+      offsets[v+1] = kept;
+   }
+   targets.resize(kept);
+}
+
+//use get_edge(v1,v2,edge) to get edge label/weight
+void Graph::dijkstra_shortest_path(int src, Map& path_costs) const {
+   Set x;
+   Set not_x;
+   for(int i=0; i<vertex_count(); ++i){
+      not_x.insert(i);
+   }
+   not_x.erase(src);
+   x.insert(src);
+
+   for(int i=0; i<vertex_count();++i){
+      path_costs[i] = std::numeric_limits<int>::max();
+   }
+   path_costs[src] = 0;
+
+   while(x.size()<vertex_count()){
+      int min_vertex = -1;
+      int min_value = std::numeric_limits<int>::max();
+      for(std::set<int>::iterator u = x.begin(); u!=x.end(); ++u){
+         std::list<int> adj_v;
+         connected_to(*u,adj_v);
+         for(int v: adj_v){
+            //if v is not in x
+            if(not_x.find(v) != not_x.end()){
+               if(path_costs[v]==std::numeric_limits<int>::max()){
+                  int edge;
+                  get_edge(*u,v,edge);
+                  if(path_costs[*u] + edge < min_value){
+                     min_value = path_costs[*u] + edge;
+                     min_vertex = v;
+                  }
+               }
+            }
+         }
+      }
+      x.insert(min_vertex);
+      not_x.erase(min_vertex);
+      path_costs[min_vertex] = min_value;
+   }
+}
+
+int Graph::k_shortest_paths(int src, int dst, int k, std::vector<std::list<int>>& paths,
+                            std::vector<long long>& costs) const {
+   paths.clear();
+   costs.clear();
+   int n = vertex_count();
+   std::vector<int> offsets;
+   std::vector<int> targets;
+   flat_adjacency(OUT_EDGES, offsets, targets);
+   std::vector<int> weights(targets.size());
+   for(int u=0; u<n; ++u){
+      for(int a=offsets[u]; a<offsets[u+1]; ++a){
+         get_edge(u,targets[a],weights[a]);
+      }
+   }
+   //the edge u->v as an index into targets
+   auto arc = [&](int u, int v){
+      return std::lower_bound(targets.begin() + offsets[u], targets.begin() + offsets[u+1], v)
+         - targets.begin();
+   };
+
+   std::vector<std::vector<int>> accepted;
+   std::vector<int> deviation;
+   //candidates ordered by cost then vertex sequence, with the index
+   //each left its parent path at
+   typedef std::pair<long long, std::vector<int>> Candidate;
+   std::set<Candidate> candidates;
+   std::map<std::vector<int>, int> candidate_deviation;
+   if(k <= 0)
+      return 0;
+   std::vector<char> vertex_mask(n, 0);
+   std::vector<char> arc_mask(targets.size(), 0);
+   std::vector<int> first;
+   long long first_cost;
+   if(!masked_dijkstra(src, dst, offsets, targets, weights, vertex_mask, arc_mask,
+                       first, first_cost))
+      return 0;
+   accepted.push_back(first);
+   deviation.push_back(0);
+   costs.push_back(first_cost);
+
+   while((int)accepted.size() < k){
+      const std::vector<int>& last = accepted.back();
+      int spurs = (int)last.size() - 1 - deviation.back();
+      std::vector<long long> root_cost(last.size(), 0);
+      for(int i=1; i<(int)last.size(); ++i){
+         root_cost[i] = root_cost[i-1] + weights[arc(last[i-1], last[i])];
+      }
+      //spur from each vertex at or after the deviation, each range of
+      //spurs with its own masks
+      std::vector<std::vector<int>> spur_paths(std::max(spurs, 0));
+      std::vector<long long> spur_costs(std::max(spurs, 0), -1);
+      parallel_for(std::max(spurs, 0), [&](int start, int end){
+         std::vector<char> vertices(n, 0);
+         std::vector<char> arcs(targets.size(), 0);
+         std::vector<int> masked_arcs;
+         for(int s=start; s<end; ++s){
+            int i = deviation.back() + s;
+            //the root path may not be revisited, and no accepted path
+            //sharing the root may be repeated
+            for(int j=0; j<i; ++j){
+               vertices[last[j]] = 1;
+            }
+            masked_arcs.clear();
+            for(const std::vector<int>& p: accepted){
+               if((int)p.size() > i+1 && std::equal(last.begin(), last.begin() + i + 1, p.begin()))
+                  masked_arcs.push_back(arc(p[i], p[i+1]));
+            }
+            for(int a: masked_arcs){
+               arcs[a] = 1;
+            }
+            std::vector<int> spur;
+            long long cost;
+            if(masked_dijkstra(last[i], dst, offsets, targets, weights, vertices, arcs,
+                               spur, cost)){
+               spur_paths[s].assign(last.begin(), last.begin() + i);
+               spur_paths[s].insert(spur_paths[s].end(), spur.begin(), spur.end());
+               spur_costs[s] = root_cost[i] + cost;
+            }
+            for(int j=0; j<i; ++j){
+               vertices[last[j]] = 0;
+            }
+            for(int a: masked_arcs){
+               arcs[a] = 0;
+            }
+         }
+      });
+      for(int s=0; s<spurs; ++s){
+         if(spur_costs[s] >= 0 && candidate_deviation.count(spur_paths[s]) == 0){
+            candidate_deviation[spur_paths[s]] = deviation.back() + s;
+            candidates.insert(Candidate(spur_costs[s], spur_paths[s]));
+         }
+      }
+      if(candidates.empty())
+         break;
+      Candidate best = *candidates.begin();
+      candidates.erase(candidates.begin());
+      accepted.push_back(best.second);
+      deviation.push_back(candidate_deviation[best.second]);
+      costs.push_back(best.first);
+   }
+
+   for(const std::vector<int>& p: accepted){
+      paths.push_back(std::list<int>(p.begin(), p.end()));
+   }
+   return paths.size();
+}
+
+bool Graph::masked_dijkstra(int src, int dst, const std::vector<int>& offsets,
+                            const std::vector<int>& targets,
+                            const std::vector<int>& weights,
+                            const std::vector<char>& vertex_mask,
+                            const std::vector<char>& arc_mask,
+                            std::vector<int>& path, long long& cost) {
+   int n = offsets.size() - 1;
+   std::vector<long long> dist(n, -1);
+   std::vector<int> parent(n, -1);
+   typedef std::pair<long long,int> Entry;
+   std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+   dist[src] = 0;
+   heap.push(Entry(0, src));
+   while(!heap.empty()){
+      Entry top = heap.top();
+      heap.pop();
+      int u = top.second;
+      if(top.first != dist[u])
+         continue;
+      if(u == dst)
+         break;
+      for(int a=offsets[u]; a<offsets[u+1]; ++a){
+         int v = targets[a];
+         if(arc_mask[a] || vertex_mask[v])
+            continue;
+         long long d = top.first + weights[a];
+         if(dist[v] == -1 || d < dist[v]){
+            dist[v] = d;
+            parent[v] = u;
+            heap.push(Entry(d, v));
+         }
+      }
+   }
+   if(dist[dst] == -1)
+      return false;
+   path.clear();
+   for(int v=dst; v!=-1; v=parent[v]){
+      path.push_back(v);
+   }
+   std::reverse(path.begin(), path.end());
+   cost = dist[dst];
+   return true;
+}
 
 void Graph::prim_min_spanning_tree(Graph& spanning_tree) const {
    Set x;
@@ -858,9 +2380,11 @@ bool Graph::path_max_independent_set(int vertex_weights[], Set& S) const {
     if(edge_count()!=vertex_count()-1)
       return false;
 
-   int A[vertex_count()+1];
-    A[0] = 0;
-    A[1] = vertex_weights[0];
+   //table on the heap with 64-bit sums so long paths neither overflow
+   //the stack nor the weights
+   std::vector<long long> A(vertex_count()+1, 0);
+   if(vertex_count() > 0)
+      A[1] = vertex_weights[0];
     for(int i=2; i<vertex_count()+1; ++i){
        A[i] = std::max(A[i-1],A[i-2] + vertex_weights[i-1]);
     }
@@ -876,6 +2400,81 @@ bool Graph::path_max_independent_set(int vertex_weights[], Set& S) const {
    return true;
 }
 
+bool Graph::forest_max_independent_set(const int vertex_weights[], Set& S) const {
+   std::vector<bool> in_set;
+   long long total_weight;
+   if(!forest_max_independent_set(vertex_weights, in_set, total_weight))
+      return false;
+   for(int v=0; v<vertex_count(); ++v){
+      if(in_set[v])
+         S.insert(v);
+   }
+   return true;
+}
+
+bool Graph::forest_max_independent_set(const int vertex_weights[], std::vector<bool>& in_set,
+                                       long long& total_weight) const {
+   int n = vertex_count();
+   std::vector<int> offsets;
+   std::vector<int> targets;
+   flat_adjacency(ALL_EDGES, offsets, targets);
+   for(int v=0; v<n; ++v){
+      if(std::binary_search(targets.begin() + offsets[v], targets.begin() + offsets[v+1], v))
+         return false;
+   }
+   //a forest has exactly n - c (undirected) edges
+   std::vector<int> components;
+   int c = union_find_connected_components(components);
+   if((long long)targets.size() != 2LL * (n - c))
+      return false;
+
+   //each tree is rooted at its smallest vertex
+   std::vector<int> roots;
+   for(int v=0; v<n; ++v){
+      if((int)roots.size() == components[v])
+         roots.push_back(v);
+   }
+
+   //best weight of v's subtree with v in (incl) or out (excl) of the set
+   std::vector<long long> incl(n,0);
+   std::vector<long long> excl(n,0);
+   std::vector<int> parent(n,-1);
+   std::vector<char> taken(n,0);
+   parallel_for_each(c, [&](int t){
+      //bfs order puts parents before children
+      std::vector<int> order(1,roots[t]);
+      for(int i=0; i<(int)order.size(); ++i){
+         int u = order[i];
+         for(int k=offsets[u]; k<offsets[u+1]; ++k){
+            int v = targets[k];
+            if(v != parent[u]){
+               parent[v] = u;
+               order.push_back(v);
+            }
+         }
+      }
+      for(int i=order.size()-1; i>=0; --i){
+         int v = order[i];
+         incl[v] += vertex_weights[v];
+         if(parent[v] != -1){
+            incl[parent[v]] += excl[v];
+            excl[parent[v]] += std::max(incl[v], excl[v]);
+         }
+      }
+      for(int v: order){
+         bool parent_taken = parent[v] != -1 && taken[parent[v]];
+         taken[v] = !parent_taken && incl[v] > excl[v];
+      }
+   });
+
+   total_weight = 0;
+   for(int r: roots){
+      total_weight += std::max(incl[r], excl[r]);
+   }
+   in_set.assign(taken.begin(), taken.end());
+   return true;
+}
+
 bool Graph::all_pairs_shortest_paths(std::vector<std::vector<int>>& weights) const {
    std::vector<std::vector<std::vector<int>>> A;
 
@@ -941,3 +2540,796 @@ bool Graph::all_pairs_shortest_paths(std::vector<std::vector<int>>& weights) con
    
    return true;
 }
+
+void Graph::multi_source_bfs(bool dir, const std::vector<int>& sources,
+                             std::vector<std::vector<int>>& distances) const {
+   int n = vertex_count();
+   std::vector<int> offsets;
+   std::vector<int> targets;
+   flat_adjacency(dir ? OUT_EDGES : ALL_EDGES, offsets, targets);
+   distances.assign(sources.size(), std::vector<int>(n,-1));
+
+   //one batch = up to 64 sources, one bit per source
+   int batches = (sources.size() + 63) / 64;
+   parallel_for(batches, [&](int first, int last){
+      std::vector<uint64_t> seen(n);
+      std::vector<uint64_t> visit(n);
+      std::vector<uint64_t> visit_next(n);
+      for(int b=first; b<last; ++b){
+         std::fill(seen.begin(), seen.end(), 0);
+         std::fill(visit.begin(), visit.end(), 0);
+         int base = b*64;
+         int width = std::min<int>(64, sources.size() - base);
+         for(int i=0; i<width; ++i){
+            int s = sources[base+i];
+            seen[s] |= uint64_t(1) << i;
+            visit[s] |= uint64_t(1) << i;
+            distances[base+i][s] = 0;
+         }
+
+         int level = 0;
+         bool active = true;
+         while(active){
+            active = false;
+            ++level;
+            for(int u=0; u<n; ++u){
+               if(visit[u] == 0)
+                  continue;
+               for(int k=offsets[u]; k<offsets[u+1]; ++k){
+                  int v = targets[k];
+                  //sources reaching v for the first time on this level
+                  uint64_t found = visit[u] & ~seen[v];
+                  if(found){
+                     visit_next[v] |= found;
+                     seen[v] |= found;
+                     active = true;
+                     while(found){
+                        distances[base + __builtin_ctzll(found)][v] = level;
+                        found &= found - 1;
+                     }
+                  }
+               }
+            }
+            visit.swap(visit_next);
+            std::fill(visit_next.begin(), visit_next.end(), 0);
+         }
+      }
+   });
+}
+
+int Graph::union_find_connected_components(Map& components) const {
+   std::vector<int> dense;
+   int c = union_find_connected_components(dense);
+   for(int i=0; i<vertex_count(); ++i){
+      components[i] = dense[i];
+   }
+   return c;
+}
+
+int Graph::union_find_connected_components(std::vector<int>& components) const {
+   int n = vertex_count();
+   std::vector<std::atomic<int>> parent(n);
+   for(int i=0; i<n; ++i){
+      parent[i].store(i);
+   }
+   //find with path halving (safe to race, parents only move toward roots)
+   auto find = [&](int x){
+      int p = parent[x].load();
+      while(p != x){
+         int gp = parent[p].load();
+         parent[x].compare_exchange_weak(p, gp);
+         x = gp;
+         p = parent[x].load();
+      }
+      return x;
+   };
+
+   parallel_for(n, [&](int start, int end){
+      std::list<int> adj_v;
+      for(int u=start; u<end; ++u){
+         adj_v.clear();
+         connected_to(u,adj_v);
+         for(int v: adj_v){
+            //link the larger root under the smaller one, retry on conflict
+            while(true){
+               int a = find(u);
+               int b = find(v);
+               if(a == b)
+                  break;
+               if(a < b)
+                  std::swap(a,b);
+               int expected = a;
+               if(parent[a].compare_exchange_strong(expected, b))
+                  break;
+            }
+         }
+      }
+   });
+
+   //roots are the smallest vertex of each component, so numbering roots
+   //in vertex order matches bfs_connected_components
+   components.assign(n,-1);
+   int c = 0;
+   for(int i=0; i<n; ++i){
+      int root = find(i);
+      if(root == i)
+         components[i] = c++;
+      else
+         components[i] = components[root];
+   }
+   return c;
+}
+
+int Graph::parallel_strongly_connected_components(Map& components) const {
+   std::vector<int> dense;
+   int c = parallel_strongly_connected_components(dense);
+   for(int i=0; i<vertex_count(); ++i){
+      components[i] = dense[i];
+   }
+   return c;
+}
+
+int Graph::parallel_strongly_connected_components(std::vector<int>& components) const {
+   int n = vertex_count();
+   std::vector<int> out_offsets;
+   std::vector<int> out_targets;
+   std::vector<int> in_offsets;
+   std::vector<int> in_targets;
+   flat_adjacency(OUT_EDGES, out_offsets, out_targets);
+   flat_adjacency(IN_EDGES, in_offsets, in_targets);
+
+   //components[v] is the id of v's root vertex once v is assigned
+   components.assign(n,-1);
+   std::vector<std::atomic<int>> color(n);
+   std::vector<int> remaining;
+   for(int i=0; i<n; ++i){
+      remaining.push_back(i);
+   }
+
+   while(!remaining.empty()){
+      int m = remaining.size();
+      for(int v: remaining){
+         color[v].store(v);
+      }
+      //forward propagation of the largest color until nothing changes
+      std::atomic<bool> changed(true);
+      while(changed.load()){
+         changed.store(false);
+         parallel_for(m, [&](int start, int end){
+            for(int i=start; i<end; ++i){
+               int u = remaining[i];
+               int cu = color[u].load();
+               for(int k=out_offsets[u]; k<out_offsets[u+1]; ++k){
+                  int w = out_targets[k];
+                  if(components[w] != -1)
+                     continue;
+                  int cw = color[w].load();
+                  while(cw < cu && !color[w].compare_exchange_weak(cw, cu)){
+                  }
+                  if(cw < cu)
+                     changed.store(true);
+               }
+            }
+         });
+      }
+
+      //each root collects the vertices of its color that reach it
+      std::vector<int> roots;
+      for(int v: remaining){
+         if(color[v].load() == v)
+            roots.push_back(v);
+      }
+      parallel_for(roots.size(), [&](int start, int end){
+         std::vector<int> s;
+         for(int i=start; i<end; ++i){
+            int r = roots[i];
+            components[r] = r;
+            s.push_back(r);
+            while(!s.empty()){
+               int u = s.back();
+               s.pop_back();
+               for(int k=in_offsets[u]; k<in_offsets[u+1]; ++k){
+                  int w = in_targets[k];
+                  //only this root's thread touches vertices of color r
+                  if(color[w].load() == r && components[w] == -1){
+                     components[w] = r;
+                     s.push_back(w);
+                  }
+               }
+            }
+         }
+      });
+
+      std::vector<int> next;
+      for(int v: remaining){
+         if(components[v] == -1)
+            next.push_back(v);
+      }
+      remaining.swap(next);
+   }
+
+   return topological_component_order(components);
+}
+
+int Graph::topological_component_order(std::vector<int>& components) const {
+   int n = vertex_count();
+   //relabel to 0..c-1 by first appearance
+   Map label;
+   for(int i=0; i<n; ++i){
+      if(label.count(components[i]) == 0){
+         int next = label.size();
+         label[components[i]] = next;
+      }
+      components[i] = label[components[i]];
+   }
+   int c = label.size();
+
+   //kahn's algorithm over the edges between components
+   std::vector<int> in_degree(c,0);
+   std::vector<std::vector<int>> out(c);
+   std::list<int> adj_v;
+   for(int u=0; u<n; ++u){
+      adj_v.clear();
+      connected_to(u,adj_v);
+      for(int v: adj_v){
+         if(components[u] != components[v]){
+            out[components[u]].push_back(components[v]);
+            ++in_degree[components[v]];
+         }
+      }
+   }
+   std::vector<int> order(c);
+   std::vector<int> ready;
+   for(int i=0; i<c; ++i){
+      if(in_degree[i] == 0)
+         ready.push_back(i);
+   }
+   int next = 0;
+   while(!ready.empty()){
+      int x = ready.back();
+      ready.pop_back();
+      order[x] = next++;
+      for(int y: out[x]){
+         if(--in_degree[y] == 0)
+            ready.push_back(y);
+      }
+   }
+   for(int i=0; i<n; ++i){
+      components[i] = order[components[i]];
+   }
+   return c;
+}
+
+void Graph::bitset_transitive_closure(bool dir, Graph& closed_graph) const {
+   std::vector<int> components;
+   std::vector<int> offsets;
+   std::vector<int> targets;
+   std::vector<std::vector<uint64_t>> reach;
+   int c = component_reachability(dir, components, offsets, targets, reach);
+   std::vector<std::vector<int>> members(c);
+   for(int v=0; v<vertex_count(); ++v){
+      members[components[v]].push_back(v);
+   }
+   for(int u=0; u<vertex_count(); ++u){
+      const std::vector<uint64_t>& row = reach[components[u]];
+      for(int w=0; w<(int)row.size(); ++w){
+         for(uint64_t bits = row[w]; bits; bits &= bits - 1){
+            for(int v: members[w*64 + __builtin_ctzll(bits)]){
+               if(v != u)
+                  closed_graph.set_edge(u,0,v);
+            }
+         }
+      }
+   }
+}
+
+void Graph::bitset_transitive_closure(bool dir,
+                                      std::vector<std::vector<uint64_t>>& reachable) const {
+   int n = vertex_count();
+   std::vector<int> components;
+   std::vector<int> offsets;
+   std::vector<int> targets;
+   std::vector<std::vector<uint64_t>> reach;
+   int c = component_reachability(dir, components, offsets, targets, reach);
+   std::vector<std::vector<int>> members(c);
+   for(int v=0; v<n; ++v){
+      members[components[v]].push_back(v);
+   }
+   reachable.assign(n, std::vector<uint64_t>((n + 63) / 64, 0));
+   //rows of vertices in the same component are identical
+   parallel_for(c, [&](int start, int end){
+      for(int x=start; x<end; ++x){
+         if(members[x].empty())
+            continue;
+         std::vector<uint64_t>& row = reachable[members[x].front()];
+         for(int w=0; w<(int)reach[x].size(); ++w){
+            for(uint64_t bits = reach[x][w]; bits; bits &= bits - 1){
+               for(int v: members[w*64 + __builtin_ctzll(bits)]){
+                  row[v/64] |= uint64_t(1) << (v%64);
+               }
+            }
+         }
+         for(int u: members[x]){
+            if(u != members[x].front())
+               reachable[u] = row;
+         }
+         for(int u: members[x]){
+            reachable[u][u/64] &= ~(uint64_t(1) << (u%64));
+         }
+      }
+   });
+}
+
+bool Graph::kahn_topological_sort(Map& vertex_ordering) const {
+   std::vector<int> dense;
+   bool acyclic = kahn_topological_sort(dense);
+   for(int i=0; i<vertex_count(); ++i){
+      if(dense[i] > 0)
+         vertex_ordering[i] = dense[i];
+   }
+   return acyclic;
+}
+
+bool Graph::kahn_topological_sort(std::vector<int>& vertex_ordering) const {
+   int n = vertex_count();
+   std::vector<int> offsets;
+   std::vector<int> targets;
+   flat_adjacency(OUT_EDGES, offsets, targets);
+   std::vector<std::atomic<int>> in_degree(n);
+   for(int i=0; i<n; ++i){
+      in_degree[i].store(0);
+   }
+   for(int v: targets){
+      ++in_degree[v];
+   }
+
+   vertex_ordering.assign(n,0);
+   std::vector<int> frontier;
+   for(int i=0; i<n; ++i){
+      if(in_degree[i].load() == 0)
+         frontier.push_back(i);
+   }
+   int ordering_index = 1;
+   std::vector<int> next;
+   std::mutex next_lock;
+   while(!frontier.empty()){
+      for(int u: frontier){
+         vertex_ordering[u] = ordering_index++;
+      }
+      next.clear();
+      parallel_for(frontier.size(), [&](int start, int end){
+         std::vector<int> found;
+         for(int i=start; i<end; ++i){
+            int u = frontier[i];
+            for(int k=offsets[u]; k<offsets[u+1]; ++k){
+               //the thread removing the last incoming edge owns v
+               if(--in_degree[targets[k]] == 0)
+                  found.push_back(targets[k]);
+            }
+         }
+         std::lock_guard<std::mutex> guard(next_lock);
+         next.insert(next.end(), found.begin(), found.end());
+      });
+      //keep the ordering independent of thread scheduling
+      std::sort(next.begin(), next.end());
+      frontier.swap(next);
+   }
+   return ordering_index == n + 1;
+}
+
+void Graph::betweenness_centrality(bool dir, bool weighted,
+                                   std::vector<double>& centrality) const {
+   approximate_betweenness_centrality(dir, weighted, vertex_count(), 0, centrality);
+}
+
+double Graph::approximate_betweenness_centrality(bool dir, bool weighted, int samples,
+                                                 unsigned seed,
+                                                 std::vector<double>& centrality) const {
+   int n = vertex_count();
+   std::vector<int> offsets;
+   std::vector<int> targets;
+   std::vector<int> weights;
+   flat_adjacency(dir ? OUT_EDGES : ALL_EDGES, offsets, targets);
+   if(weighted){
+      weights.resize(targets.size());
+      for(int u=0; u<n; ++u){
+         for(int k=offsets[u]; k<offsets[u+1]; ++k){
+            int v = targets[k];
+            int forward;
+            int backward;
+            bool has_forward = get_edge(u,v,forward);
+            bool has_backward = !dir && get_edge(v,u,backward);
+            if(!has_forward || (has_backward && backward < forward))
+               forward = backward;
+            weights[k] = forward;
+         }
+      }
+   }
+
+   //sample without replacement (every vertex when samples >= n)
+   std::vector<int> sources(n);
+   for(int v=0; v<n; ++v){
+      sources[v] = v;
+   }
+   if(samples < n){
+      std::mt19937 rng(seed);
+      for(int i=0; i<samples; ++i){
+         std::uniform_int_distribution<int> pick(i, n-1);
+         std::swap(sources[i], sources[pick(rng)]);
+      }
+      sources.resize(std::max(samples, 0));
+   }
+   int k = sources.size();
+
+   //one block of sources and one accumulator per thread, summed in
+   //block order so the result does not depend on scheduling
+   int blocks = std::max(1, std::min<int>(k, std::thread::hardware_concurrency()));
+   std::vector<std::vector<double>> partial(blocks, std::vector<double>(n, 0.0));
+   parallel_for(blocks, [&](int start, int end){
+      for(int b=start; b<end; ++b){
+         std::vector<int> block(sources.begin() + (long long)k*b/blocks,
+                                sources.begin() + (long long)k*(b+1)/blocks);
+         brandes_dependencies(block, offsets, targets, weights, partial[b]);
+      }
+   });
+
+   //each undirected pair is seen from both ends
+   double scale = dir ? 1.0 : 0.5;
+   if(k > 0 && k < n)
+      scale *= (double)n / k;
+   centrality.assign(n, 0.0);
+   for(int b=0; b<blocks; ++b){
+      for(int v=0; v<n; ++v){
+         centrality[v] += partial[b][v];
+      }
+   }
+   for(int v=0; v<n; ++v){
+      centrality[v] *= scale;
+   }
+   if(k >= n)
+      return 0.0;
+   if(k == 0)
+      return std::numeric_limits<double>::infinity();
+   //each source adds between 0 and n-2 to a vertex, union bound over
+   //the n vertices
+   double per_source = n > 2 ? n - 2 : 0;
+   return (dir ? 1.0 : 0.5) * n * per_source * std::sqrt(std::log(2.0 * n / 0.05) / (2.0 * k));
+}
+
+int Graph::pagerank(double damping, double tolerance, int max_iterations,
+                    std::vector<double>& ranks) const {
+   int n = vertex_count();
+   std::vector<std::vector<double>> uniform(n > 0 ? 1 : 0, std::vector<double>(n, 1.0));
+   std::vector<std::vector<double>> batch;
+   int iterations = personalized_pagerank(damping, tolerance, max_iterations, uniform, batch);
+   if(n > 0)
+      ranks.swap(batch[0]);
+   else
+      ranks.clear();
+   return iterations;
+}
+
+int Graph::personalized_pagerank(double damping, double tolerance, int max_iterations,
+                                 const std::vector<std::vector<double>>& personalization,
+                                 std::vector<std::vector<double>>& ranks) const {
+   int n = vertex_count();
+   int b = personalization.size();
+   //teleport[v*b+i] is the normalized personalization of v for query i
+   std::vector<double> teleport((size_t)n*b);
+   for(int i=0; i<b; ++i){
+      if((int)personalization[i].size() != n)
+         return -1;
+      double total = 0;
+      for(int v=0; v<n; ++v){
+         if(!(personalization[i][v] >= 0))
+            return -1;
+         total += personalization[i][v];
+      }
+      if(!(total > 0))
+         return -1;
+      for(int v=0; v<n; ++v){
+         teleport[(size_t)v*b+i] = personalization[i][v] / total;
+      }
+   }
+   ranks.assign(b, std::vector<double>(n, 0.0));
+   if(n == 0 || b == 0)
+      return 0;
+
+   std::vector<int> offsets;
+   std::vector<int> sources;
+   flat_adjacency(IN_EDGES, offsets, sources);
+   std::vector<double> inverse_degree(n, 0.0);
+   for(int u: sources){
+      inverse_degree[u] += 1;
+   }
+   for(int u=0; u<n; ++u){
+      if(inverse_degree[u] > 0)
+         inverse_degree[u] = 1.0 / inverse_degree[u];
+   }
+
+   //one contiguous range of vertices per block, with per-block sums
+   //combined in block order
+   int blocks = std::max(1, std::min<int>(n, std::thread::hardware_concurrency()));
+   std::vector<std::vector<double>> block_sums(blocks, std::vector<double>(b));
+   std::vector<double> rank(teleport);
+   std::vector<double> next((size_t)n*b);
+   std::vector<double> contribution((size_t)n*b);
+   std::vector<double> dangling(b);
+   std::vector<double> change(b);
+   int iteration = 0;
+   while(iteration < max_iterations){
+      ++iteration;
+      //scale ranks by out-degree and total the rank of dangling vertices
+      parallel_for(blocks, [&](int start, int end){
+         for(int k=start; k<end; ++k){
+            std::vector<double>& sum = block_sums[k];
+            std::fill(sum.begin(), sum.end(), 0.0);
+            for(int u=(long long)n*k/blocks; u<(long long)n*(k+1)/blocks; ++u){
+               const double* r = &rank[(size_t)u*b];
+               double* c = &contribution[(size_t)u*b];
+               double scale = inverse_degree[u];
+               for(int i=0; i<b; ++i){
+                  c[i] = r[i] * scale;
+               }
+               if(scale == 0){
+                  for(int i=0; i<b; ++i){
+                     sum[i] += r[i];
+                  }
+               }
+            }
+         }
+      });
+      std::fill(dangling.begin(), dangling.end(), 0.0);
+      for(int k=0; k<blocks; ++k){
+         for(int i=0; i<b; ++i){
+            dangling[i] += block_sums[k][i];
+         }
+      }
+      //pull from in-neighbors, then measure the change
+      parallel_for(blocks, [&](int start, int end){
+         for(int k=start; k<end; ++k){
+            std::vector<double>& sum = block_sums[k];
+            std::fill(sum.begin(), sum.end(), 0.0);
+            for(int v=(long long)n*k/blocks; v<(long long)n*(k+1)/blocks; ++v){
+               double* x = &next[(size_t)v*b];
+               std::fill(x, x+b, 0.0);
+               for(int e=offsets[v]; e<offsets[v+1]; ++e){
+                  const double* c = &contribution[(size_t)sources[e]*b];
+                  for(int i=0; i<b; ++i){
+                     x[i] += c[i];
+                  }
+               }
+               const double* t = &teleport[(size_t)v*b];
+               const double* r = &rank[(size_t)v*b];
+               for(int i=0; i<b; ++i){
+                  x[i] = damping * (x[i] + dangling[i] * t[i]) + (1 - damping) * t[i];
+                  sum[i] += std::fabs(x[i] - r[i]);
+               }
+            }
+         }
+      });
+      rank.swap(next);
+      std::fill(change.begin(), change.end(), 0.0);
+      for(int k=0; k<blocks; ++k){
+         for(int i=0; i<b; ++i){
+            change[i] += block_sums[k][i];
+         }
+      }
+      if(*std::max_element(change.begin(), change.end()) < tolerance)
+         break;
+   }
+
+   for(int v=0; v<n; ++v){
+      for(int i=0; i<b; ++i){
+         ranks[i][v] = rank[(size_t)v*b+i];
+      }
+   }
+   return iteration;
+}
+
+void Graph::brandes_dependencies(const std::vector<int>& sources,
+                                 const std::vector<int>& offsets,
+                                 const std::vector<int>& targets,
+                                 const std::vector<int>& weights,
+                                 std::vector<double>& centrality) const {
+   int n = vertex_count();
+   bool weighted = !weights.empty();
+   std::vector<long long> dist(n,-1);
+   std::vector<double> sigma(n,0.0);
+   std::vector<double> delta(n,0.0);
+   std::vector<int> order;
+   order.reserve(n);
+   typedef std::pair<long long,int> Entry;
+   std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+   for(int s: sources){
+      //settle vertices in order of distance, counting shortest paths
+      order.clear();
+      dist[s] = 0;
+      sigma[s] = 1;
+      if(!weighted){
+         order.push_back(s);
+         for(int i=0; i<(int)order.size(); ++i){
+            int u = order[i];
+            for(int k=offsets[u]; k<offsets[u+1]; ++k){
+               int v = targets[k];
+               if(dist[v] == -1){
+                  dist[v] = dist[u] + 1;
+                  order.push_back(v);
+               }
+               if(dist[v] == dist[u] + 1)
+                  sigma[v] += sigma[u];
+            }
+         }
+      } else {
+         heap.push(Entry(0,s));
+         while(!heap.empty()){
+            Entry top = heap.top();
+            heap.pop();
+            int u = top.second;
+            //delta doubles as the settled mark until accumulation
+            if(top.first != dist[u] || delta[u] < 0)
+               continue;
+            delta[u] = -1;
+            order.push_back(u);
+            for(int k=offsets[u]; k<offsets[u+1]; ++k){
+               int v = targets[k];
+               if(v == u)
+                  continue;
+               long long d = dist[u] + weights[k];
+               if(dist[v] == -1 || d < dist[v]){
+                  dist[v] = d;
+                  sigma[v] = sigma[u];
+                  heap.push(Entry(d,v));
+               } else if(d == dist[v]){
+                  sigma[v] += sigma[u];
+               }
+            }
+         }
+         for(int u: order){
+            delta[u] = 0;
+         }
+      }
+      //accumulate dependencies over successors, farthest vertices first
+      for(int i=order.size()-1; i>=0; --i){
+         int u = order[i];
+         for(int k=offsets[u]; k<offsets[u+1]; ++k){
+            int v = targets[k];
+            long long w = weighted ? weights[k] : 1;
+            if(v != u && dist[v] == dist[u] + w)
+               delta[u] += sigma[u] / sigma[v] * (1 + delta[v]);
+         }
+         if(u != s)
+            centrality[u] += delta[u];
+      }
+      for(int u: order){
+         dist[u] = -1;
+         sigma[u] = 0;
+         delta[u] = 0;
+      }
+   }
+}
+
+void Graph::condensation(bool dir, const std::vector<int>& components, int c,
+                         std::vector<int>& offsets, std::vector<int>& targets) const {
+   std::vector<std::vector<int>> out(c);
+   std::list<int> adj_v;
+   for(int u=0; u<vertex_count(); ++u){
+      adj_v.clear();
+      if(dir)
+         connected_to(u,adj_v);
+      else
+         adjacent(u,adj_v);
+      for(int v: adj_v){
+         if(components[u] != components[v])
+            out[components[u]].push_back(components[v]);
+      }
+   }
+   offsets.assign(c+1, 0);
+   targets.clear();
+   for(int x=0; x<c; ++x){
+      std::sort(out[x].begin(), out[x].end());
+      out[x].erase(std::unique(out[x].begin(), out[x].end()), out[x].end());
+      targets.insert(targets.end(), out[x].begin(), out[x].end());
+      offsets[x+1] = targets.size();
+   }
+}
+
+int Graph::component_reachability(bool dir, std::vector<int>& components,
+                                  std::vector<int>& offsets,
+                                  std::vector<int>& targets,
+                                  std::vector<std::vector<uint64_t>>& reach) const {
+   int c;
+   if(dir)
+      c = strongly_connected_components(components);
+   else
+      c = union_find_connected_components(components);
+   condensation(dir, components, c, offsets, targets);
+
+   //height of each component above the sinks of the component graph,
+   //components are numbered topologically so successors come later
+   std::vector<int> height(c,0);
+   int max_height = 0;
+   for(int x=c-1; x>=0; --x){
+      for(int k=offsets[x]; k<offsets[x+1]; ++k){
+         height[x] = std::max(height[x], height[targets[k]] + 1);
+      }
+      max_height = std::max(max_height, height[x]);
+   }
+   std::vector<std::vector<int>> levels(max_height + 1);
+   for(int x=0; x<c; ++x){
+      levels[height[x]].push_back(x);
+   }
+
+   int words = (c + 63) / 64;
+   reach.assign(c, std::vector<uint64_t>(words, 0));
+   for(const std::vector<int>& level: levels){
+      parallel_for(level.size(), [&](int start, int end){
+         for(int i=start; i<end; ++i){
+            int x = level[i];
+            std::vector<uint64_t>& row = reach[x];
+            row[x/64] |= uint64_t(1) << (x%64);
+            for(int k=offsets[x]; k<offsets[x+1]; ++k){
+               const std::vector<uint64_t>& succ = reach[targets[k]];
+               for(int w=0; w<words; ++w){
+                  row[w] |= succ[w];
+               }
+            }
+         }
+      });
+   }
+   return c;
+}
+
+void Graph::flat_adjacency(EdgeDirection d, std::vector<int>& offsets,
+                           std::vector<int>& targets) const {
+   int n = vertex_count();
+   offsets.assign(n+1, 0);
+   targets.clear();
+   targets.reserve(d == ALL_EDGES ? 2*edge_count() : edge_count());
+   std::list<int> adj_v;
+   for(int u=0; u<n; ++u){
+      adj_v.clear();
+      if(d == OUT_EDGES)
+         connected_to(u,adj_v);
+      else if(d == IN_EDGES)
+         connected_from(u,adj_v);
+      else
+         adjacent(u,adj_v);
+      adj_v.sort();
+      adj_v.unique();
+      targets.insert(targets.end(), adj_v.begin(), adj_v.end());
+      offsets[u+1] = targets.size();
+   }
+}
+
+void Graph::parallel_for_each(int n, const std::function<void(int)>& body) {
+   std::atomic<int> next(0);
+   //one range per worker, each worker claims indices until none are left
+   int threads = std::max(1, std::min<int>(n, std::thread::hardware_concurrency()));
+   parallel_for(threads, [&](int start, int end){
+      for(int worker=start; worker<end; ++worker){
+         for(int i = next++; i < n; i = next++){
+            body(i);
+         }
+      }
+   });
+}
+
+void Graph::parallel_for(int n, const std::function<void(int,int)>& body) {
+   int threads = std::thread::hardware_concurrency();
+   if(threads > n)
+      threads = n;
+   if(threads <= 1){
+      if(n > 0)
+         body(0,n);
+      return;
+   }
+   int chunk = (n + threads - 1) / threads;
+   std::vector<std::thread> workers;
+   for(int start=0; start<n; start+=chunk){
+      workers.push_back(std::thread(body, start, std::min(n, start+chunk)));
+   }
+   for(std::thread& t: workers){
+      t.join();
+   }
+}
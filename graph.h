@@ -10,6 +10,8 @@
 #ifndef GRAPH_H
 #define GRAPH_H
 
+#include <cstdint>
+#include <functional>
 #include <list>
 #include <set>
 #include <unordered_map>
@@ -74,7 +76,9 @@ public:
   void bfs(bool dir, int src, Map& tree) const;
   
   //----------------------------------------------------------------------
-  // Shortest path length from source to destination vertices.
+  // Shortest path length from source to destination vertices. Runs a
+  // bidirectional breadth-first search (over incoming edges from dst
+  // when directed) that stops as soon as the two searches meet.
   //
   // Conditions:
   //   The source and destination vertices must be unique.  
@@ -83,7 +87,8 @@ public:
   //   src -- the vertex starting the path
   //   dst -- the vertex ending the path
   // Outputs:
-  //   path -- sequence of nodes that define the shortest path
+  //   path -- sequence of nodes that define the shortest path (empty
+  //           if there is no path)
   //----------------------------------------------------------------------
   void shortest_path_length(bool dir, int src, int dst, std::list<int>& path) const;
 
@@ -176,19 +181,29 @@ public:
   //----------------------------------------------------------------------
 
   //----------------------------------------------------------------------
-  // Computes the strongly connected components.
+  // Computes the strongly connected components using a single-pass
+  // iterative version of Tarjan's algorithm.
   //
   // Inputs:
   //   none
   // Outputs: 
   //   components -- mapping from each graph vertex to its corresponding
   //                 component number where component numbers range from
-  //                 0 to c-1 (for c components)
+  //                 0 to c-1 (for c components) in topological order,
+  //                 i.e., every edge u->v has components[u] <=
+  //                 components[v]
+  // Returns:
+  //   the number of components c (dense version)
   //----------------------------------------------------------------------
   void strongly_connected_components(Map& components) const;
+  int strongly_connected_components(std::vector<int>& components) const;
 
   //----------------------------------------------------------------------
-  // Computes the transitive reduction.
+  // Computes the transitive reduction. Each strongly connected
+  // component becomes a cycle through its vertices (in vertex order),
+  // and the component graph is reduced using reachability bitsets:
+  // an edge between components is kept only if its target is not
+  // reachable through an earlier (in topological order) successor.
   //
   // Conditions: Assumes that the given graph (the closed_graph) has
   //             the same number of nodes as the current graph. But
@@ -203,9 +218,11 @@ public:
 
   //----------------------------------------------------------------------
   // Check if an eulerian exists in a directed graph, and if so,
-  // return one.
+  // return one. Uses Hierholzer's algorithm with a cursor into each
+  // vertex's flat out-edge list, so runs in O(V+E).
   //
-  // Conditions: Assumes the graph is not disconnected.
+  // Conditions: Returns false if the edges are not all connected
+  //             (isolated vertices are ignored).
   //
   // Inputs:
   //   none
@@ -221,20 +238,38 @@ public:
 
   //----------------------------------------------------------------------
   // Returns a Hamiltonian path if one exists in the current graph.
+  // Graphs that fail the degree or strongly connected component checks
+  // are rejected up front. Graphs with at most held_karp_max_vertices
+  // vertices are solved with the Held-Karp subset dynamic program
+  // (subsets of the same size are computed in parallel), larger graphs
+  // with backtracking that visits components in topological order.
   //
   // Conditions: Treats the graph as directed.
   //
+  // Inputs:
+  //   time_limit_ms -- give up after roughly this many milliseconds
+  //                    (negative for no limit)
   // Outputs:
-  //   path -- the Hamiltonian path
+  //   path      -- the Hamiltonian path
+  //   timed_out -- true if the search gave up before finishing
   //
   // Returns:
-  //   true if a Hamiltonian path exists, false otherwise.
+  //   true if a Hamiltonian path exists, false otherwise (or if the
+  //   search timed out).
   //----------------------------------------------------------------------
   bool directed_hamiltonian_path(std::list<int>& path) const;
+  bool directed_hamiltonian_path(std::list<int>& path, int time_limit_ms,
+                                 bool& timed_out) const;
+
+  // largest graph solved with the Held-Karp dynamic program, which uses
+  // 2^n 32-bit words
+  static const int held_karp_max_vertices = 24;
 
   //----------------------------------------------------------------------
-  // Find a maximum matched graph using the augmenting paths algorithm
-  // from the textbook.
+  // Find a maximum matched graph using the Hopcroft-Karp algorithm,
+  // which augments along a maximal set of shortest augmenting paths in
+  // each phase (O(E sqrt(V)) overall). Mates are kept in flat arrays and
+  // the output graph is only written once the matching is complete.
   //
   // Conditions: Finds a matching only if the current graph is bipartite
   //
@@ -243,15 +278,41 @@ public:
   //                        graph, containing the edges in the
   //                        matching. The output graph is assumed to
   //                        be initialized with the same number of
-  //                        vertices, but without any edges.
+  //                        vertices, but without any edges. Edges go
+  //                        from color 0 to color 1 vertices (see
+  //                        bipartite_graph).
   // Returns:
   //   true if the current graph is bipartite, false otherwise
   //----------------------------------------------------------------------
   bool bipartite_graph_matching(Graph& max_matched_graph) const;
 
+  //----------------------------------------------------------------------
+  // Find a minimum-cost assignment in a bipartite graph whose edge
+  // labels are costs, using the epsilon-scaling auction algorithm.
+  // Unassigned vertices compute their bids in parallel in each round.
+  //
+  // Conditions: Both sides of the bipartite graph (see bipartite_graph)
+  //             must have the same number of vertices and a perfect
+  //             matching must exist.
+  //
+  // Output:
+  //   assignment -- A graph with same vertices as original graph,
+  //                 initialized without any edges, to which the
+  //                 assigned edges (with their costs) are added from
+  //                 color 0 to color 1 vertices.
+  //   cost       -- the total cost of the assignment
+  // Returns:
+  //   true if the graph is bipartite and has a perfect matching,
+  //   false otherwise
+  //----------------------------------------------------------------------
+  bool min_cost_bipartite_assignment(Graph& assignment, long long& cost) const;
+
   //----------------------------------------------------------------------
   // Finds all (maximal) cliques in the graph using the Bron-Kerbosch
-  // algorithm.
+  // algorithm with Tomita pivoting. The outer level follows a
+  // degeneracy ordering and its vertices are handed out to threads
+  // one at a time as threads become free. Candidate sets are sorted
+  // vectors intersected against flat neighbor arrays.
   //
   // Conditions: Assumes the graph is undirected.
   //
@@ -259,6 +320,33 @@ public:
   //   cliques -- a list of list of vertices denoting a maximal clique
   //----------------------------------------------------------------------
   void cliques(std::list<Set>& cliques) const;
+
+  //----------------------------------------------------------------------
+  // Streaming version of cliques that hands each maximal clique to a
+  // callback as soon as it is found instead of storing them, so memory
+  // use is bounded by the recursion depth. Branches that cannot reach
+  // min_size vertices are pruned.
+  //
+  // Conditions: Assumes the graph is undirected. Calls to sink are
+  //             serialized but may come from any worker thread.
+  //
+  // Input:
+  //   min_size -- smallest clique size passed to sink
+  //   sink     -- called once for each maximal clique
+  //----------------------------------------------------------------------
+  void cliques(int min_size, const std::function<void(const Set&)>& sink) const;
+
+  //----------------------------------------------------------------------
+  // Finds a maximum clique with branch-and-bound, using greedy coloring
+  // of the candidate set as an upper bound on how far each branch can
+  // grow (Tomita's MCQ).
+  //
+  // Conditions: Assumes the graph is undirected.
+  //
+  // Output:
+  //   clique -- the vertices of a largest clique
+  //----------------------------------------------------------------------
+  void maximum_clique(Set& clique) const;
   
 
   //----------------------------------------------------------------------
@@ -280,6 +368,33 @@ public:
   //                given as path_costs[v].
   //----------------------------------------------------------------------
   void dijkstra_shortest_path(int src, Map& path_costs) const;
+
+  //----------------------------------------------------------------------
+  // The k shortest loopless paths from src to dst using Yen's
+  // algorithm with Lawler's optimization (spur paths are only computed
+  // from the vertex where a path left its parent path onward). Each
+  // spur path comes from a heap-based Dijkstra that skips masked
+  // vertices and edges rather than copying the graph, and the spur
+  // paths for each accepted path are computed in parallel.
+  //
+  // Conditions: Assumes graph is directed and that edge labels
+  //             (weights) are non-negative
+  //
+  // Input:
+  //  src -- the source vertex
+  //  dst -- the destination vertex
+  //  k   -- the number of paths wanted
+  //
+  // Output:
+  //  paths -- up to k distinct loopless paths (each a sequence of
+  //           vertices from src to dst) in order of cost
+  //  costs -- costs[i] is the total weight of paths[i]
+  //
+  // Returns: the number of paths found (less than k if there are no
+  //          more)
+  //----------------------------------------------------------------------
+  int k_shortest_paths(int src, int dst, int k, std::vector<std::list<int>>& paths,
+                       std::vector<long long>& costs) const;
   
   //----------------------------------------------------------------------
   // Compute a minimum spanning tree using Prim's algorithm.
@@ -358,6 +473,27 @@ public:
   //----------------------------------------------------------------------
   bool path_max_independent_set(int vertex_weights[], Set& S) const;
 
+  //----------------------------------------------------------------------
+  // Finds a maximum-weight independent set for a forest (treating edges
+  // as undirected, with vertices in any order) using dynamic
+  // programming over an iterative post-order of each tree. Trees are
+  // solved in parallel and weights are summed in 64 bits.
+  //
+  // Input:
+  //  vertex_weights -- weights for each of the n vertices in the graph
+  //
+  // Output:
+  //  S            -- set of vertices representing the maximum
+  //                  independent set
+  //  in_set       -- dense version, in_set[v] is true if v is in the set
+  //  total_weight -- sum of the weights of the set
+  //
+  // Returns: true if the graph is a forest, false otherwise
+  //----------------------------------------------------------------------
+  bool forest_max_independent_set(const int vertex_weights[], Set& S) const;
+  bool forest_max_independent_set(const int vertex_weights[], std::vector<bool>& in_set,
+                                  long long& total_weight) const;
+
   //----------------------------------------------------------------------
   // Finds all-pairs shortest paths using the Floyd-Warshall algorithm.
   //
@@ -373,14 +509,483 @@ public:
   //          otherwise
   //----------------------------------------------------------------------
   bool all_pairs_shortest_paths(std::vector<std::vector<int>>& weights) const;
+
+
+  //----------------------------------------------------------------------
+  // Large-graph operations
+  //----------------------------------------------------------------------
+
+  //----------------------------------------------------------------------
+  // Hop distances from many sources at once using a bit-parallel
+  // multi-source breadth-first search. Sources are processed 64 at a
+  // time with one bitmask per vertex, so each neighbor scan is shared
+  // by every source in the batch.
+  //
+  // Inputs:
+  //   dir     -- true if directed
+  //   sources -- the source vertices
+  // Outputs:
+  //   distances -- distances[i][v] is the number of edges on a shortest
+  //                path from sources[i] to v, or -1 if there is no path
+  //----------------------------------------------------------------------
+  void multi_source_bfs(bool dir, const std::vector<int>& sources,
+                        std::vector<std::vector<int>>& distances) const;
+
+  //----------------------------------------------------------------------
+  // Find weakly-connected components with a concurrent union-find over
+  // the edges (each thread unions the out edges of a range of vertices).
+  //
+  // Inputs:
+  //   None
+  // Outputs:
+  //   components -- mapping from each graph vertex to its corresponding
+  //                 component number where component numbers range from
+  //                 0 to c-1 (for c components), numbered in order of
+  //                 each component's smallest vertex (as in
+  //                 bfs_connected_components)
+  // Returns:
+  //   the number of components c
+  //----------------------------------------------------------------------
+  int union_find_connected_components(Map& components) const;
+  int union_find_connected_components(std::vector<int>& components) const;
+
+  //----------------------------------------------------------------------
+  // Computes the strongly connected components in parallel using the
+  // coloring algorithm: the largest vertex id is propagated forward
+  // until it stabilizes, then each vertex whose color is its own id
+  // collects its component with a backward search restricted to its
+  // color, and the remaining vertices are recolored.
+  //
+  // Outputs: 
+  //   components -- same numbering contract as
+  //                 strongly_connected_components (0 to c-1 in
+  //                 topological order)
+  // Returns:
+  //   the number of components c
+  //----------------------------------------------------------------------
+  int parallel_strongly_connected_components(Map& components) const;
+  int parallel_strongly_connected_components(std::vector<int>& components) const;
+
+  //----------------------------------------------------------------------
+  // Computes the transitive closure by first condensing the strongly
+  // connected components and then combining reachability bitsets of
+  // the components in reverse topological order (components at the
+  // same height in the component graph are processed in parallel).
+  //
+  // Conditions: Assumes that the given graph (the closed_graph) is a
+  //             copy of the current graph prior to the call.
+  //
+  // Inputs:
+  //   dir -- if true assumes graph is directed
+  // Outputs:
+  //   closed_graph -- edges (with label 0) are added from each vertex
+  //                   u to every other vertex reachable from u
+  //   reachable    -- bit matrix version, where bit v%64 of
+  //                   reachable[u][v/64] is set if v != u is
+  //                   reachable from u
+  //----------------------------------------------------------------------
+  void bitset_transitive_closure(bool dir, Graph& closed_graph) const;
+  void bitset_transitive_closure(bool dir,
+                                 std::vector<std::vector<uint64_t>>& reachable) const;
+
+  //----------------------------------------------------------------------
+  // Computes a topological sort using Kahn's algorithm over cached
+  // in-degrees. Each frontier of vertices with no remaining incoming
+  // edges is processed in parallel.
+  //
+  // Conditions: Assumes the graph is directed.
+  //
+  // Outputs:
+  //   vertex_ordering -- a map from vertex to it's corresponding
+  //                      order in the topological sort (where nodes
+  //                      are ordered from 1 to n), vertices on or
+  //                      after a cycle are left out
+  // Returns:
+  //   true if the graph is acyclic (every vertex was ordered)
+  //----------------------------------------------------------------------
+  bool kahn_topological_sort(Map& vertex_ordering) const;
+  bool kahn_topological_sort(std::vector<int>& vertex_ordering) const;
+
+  //----------------------------------------------------------------------
+  // Builds the (duplicate-free) edges between components as flat
+  // arrays.
+  //
+  // Inputs:
+  //   dir        -- true to follow edge directions
+  //   components -- components[v] is the component of v, from 0 to c-1
+  //   c          -- the number of components
+  // Outputs:
+  //   offsets, targets -- the components with an edge from component x
+  //                       are targets[offsets[x]] up to
+  //                       targets[offsets[x+1]-1], in increasing order
+  //----------------------------------------------------------------------
+  void condensation(bool dir, const std::vector<int>& components, int c,
+                    std::vector<int>& offsets, std::vector<int>& targets) const;
+
+  //----------------------------------------------------------------------
+  // Betweenness centrality using Brandes' algorithm (breadth-first
+  // search when unweighted, Dijkstra over the edge labels when
+  // weighted). Sources are split across threads, each accumulating
+  // dependencies into its own array, and the arrays are summed at the
+  // end. For undirected graphs each pair is counted once.
+  //
+  // Conditions: Assumes edge labels are positive when weighted.
+  //
+  // Inputs:
+  //   dir      -- true if directed
+  //   weighted -- true to use edge labels as weights
+  // Outputs:
+  //   centrality -- centrality[v] is the sum over pairs s,t (neither
+  //                 v) of the fraction of shortest s-t paths through v
+  //----------------------------------------------------------------------
+  void betweenness_centrality(bool dir, bool weighted,
+                              std::vector<double>& centrality) const;
+
+  //----------------------------------------------------------------------
+  // Estimates betweenness centrality from a uniform sample of distinct
+  // sources (the exact result when samples >= n), scaling the sampled
+  // dependencies by n/samples.
+  //
+  // Inputs:
+  //   dir, weighted -- as in betweenness_centrality
+  //   samples       -- the number of sources to sample
+  //   seed          -- seed for choosing the sources
+  // Outputs:
+  //   centrality -- estimated centrality of each vertex
+  // Returns:
+  //   a (hoeffding) bound e such that, with probability at least 0.95,
+  //   every estimate is within e of the exact centrality
+  //----------------------------------------------------------------------
+  double approximate_betweenness_centrality(bool dir, bool weighted, int samples,
+                                            unsigned seed,
+                                            std::vector<double>& centrality) const;
+
+  //----------------------------------------------------------------------
+  // PageRank by power iteration over a pull layout (the in-neighbors of
+  // every vertex, from connected_from, copied into flat arrays), so
+  // each vertex gathers its new rank from contiguous arrays and vertex
+  // ranges are updated in parallel. Vertices with no out edges spread
+  // their rank over all vertices.
+  //
+  // Inputs:
+  //   damping        -- probability of following an edge (e.g., 0.85)
+  //   tolerance      -- stop once the ranks change by less than this
+  //                     (sum of absolute differences)
+  //   max_iterations -- stop after this many iterations
+  // Outputs:
+  //   ranks -- ranks[v] is the rank of v (ranks sum to 1)
+  // Returns:
+  //   the number of iterations run
+  //----------------------------------------------------------------------
+  int pagerank(double damping, double tolerance, int max_iterations,
+               std::vector<double>& ranks) const;
+
+  //----------------------------------------------------------------------
+  // Personalized PageRank for a batch of personalization vectors at
+  // once, where each teleport (and each dangling vertex) jumps to v
+  // with probability proportional to personalization[i][v]. The batch
+  // is stored interleaved by vertex so one pass over the in-neighbors
+  // updates every vector.
+  //
+  // Inputs:
+  //   damping, tolerance, max_iterations -- as in pagerank (the
+  //                                         tolerance applies to each
+  //                                         vector)
+  //   personalization -- one vector of n non-negative weights per
+  //                      query (normalized to sum to 1)
+  // Outputs:
+  //   ranks -- ranks[i][v] is the rank of v for personalization[i]
+  // Returns:
+  //   the number of iterations run, or -1 if a personalization vector
+  //   does not have n non-negative weights with a positive sum
+  //----------------------------------------------------------------------
+  int personalized_pagerank(double damping, double tolerance, int max_iterations,
+                            const std::vector<std::vector<double>>& personalization,
+                            std::vector<std::vector<double>>& ranks) const;
+
+  //----------------------------------------------------------------------
+  // Counts triangles (ignoring edge direction and self loops). Each
+  // edge is oriented from the lower to the higher ranked endpoint
+  // (ranked by degree, then vertex), so every triangle is found once,
+  // at its lowest ranked vertex, by intersecting sorted out-lists.
+  // Vertices are handed out to threads as they become free.
+  //
+  // Outputs:
+  //   triangles -- triangles[v] is the number of triangles containing v
+  // Returns:
+  //   the number of triangles in the graph
+  //----------------------------------------------------------------------
+  long long triangle_count() const;
+  long long triangle_count(std::vector<long long>& triangles) const;
+
+  //----------------------------------------------------------------------
+  // Local clustering coefficient of each vertex (ignoring edge
+  // direction and self loops): the fraction of pairs of its neighbors
+  // that are adjacent, or 0 for vertices with fewer than 2 neighbors.
+  //
+  // Outputs:
+  //   coefficients -- coefficients[v] is the coefficient of v
+  //----------------------------------------------------------------------
+  void local_clustering_coefficients(std::vector<double>& coefficients) const;
+
+  //----------------------------------------------------------------------
+  // Global transitivity (ignoring edge direction and self loops): three
+  // times the number of triangles over the number of connected triples
+  // (paths of two edges), or 0 if there are no triples.
+  //----------------------------------------------------------------------
+  double transitivity() const;
+
+  //----------------------------------------------------------------------
+  // Core decomposition (ignoring edge direction and self loops) using
+  // the Batagelj-Zaversnik bucket algorithm over flat arrays, which
+  // removes a vertex of minimum remaining degree at each step in O(E)
+  // total time. A vertex has core number k if it belongs to the
+  // largest subgraph in which every vertex has degree at least k but
+  // not to the one for k+1.
+  //
+  // Outputs:
+  //   core  -- core[v] is the core number of v
+  //   order -- the vertices in degeneracy order (the order they were
+  //            removed, each having at most the degeneracy many
+  //            neighbors later in the order)
+  // Returns:
+  //   the degeneracy of the graph (the largest core number)
+  //----------------------------------------------------------------------
+  int core_decomposition(std::vector<int>& core) const;
+  int core_decomposition(std::vector<int>& core, std::vector<int>& order) const;
+
+  //----------------------------------------------------------------------
+  // Core decomposition by parallel peeling: for k = 0, 1, ... every
+  // vertex of remaining degree at most k is removed at once, in
+  // rounds, with threads sharing out each round and decrementing the
+  // degrees of neighbors atomically.
+  //
+  // Outputs:
+  //   core -- same as core_decomposition
+  // Returns:
+  //   the degeneracy of the graph
+  //----------------------------------------------------------------------
+  int parallel_core_decomposition(std::vector<int>& core) const;
+
+  //----------------------------------------------------------------------
+  // Extracts the k-core, the subgraph induced by the vertices with core
+  // number at least k.
+  //
+  // Conditions: Assumes core_graph is initialized with the same
+  //             vertices as the current graph, but with no edges (on
+  //             input).
+  //
+  // Inputs:
+  //   k -- the core to extract
+  // Outputs:
+  //   core_graph -- the edges (with their labels) of the current graph
+  //                 between vertices in the k-core
+  // Returns:
+  //   the number of vertices in the k-core
+  //----------------------------------------------------------------------
+  int k_core(int k, Graph& core_graph) const;
+
+  //----------------------------------------------------------------------
+  // Maximum flow from src to dst, where edge labels are capacities,
+  // using highest-label push-relabel with global relabeling (a
+  // backward breadth-first search from dst, run periodically) and the
+  // gap heuristic. The first phase finds a maximum preflow and the
+  // second returns the excess that cannot reach dst to src.
+  //
+  // Conditions: Assumes the graph is directed (negative capacities
+  //             are treated as 0), and that flow is initialized with
+  //             the same vertices as the current graph, but with no
+  //             edges (on input).
+  //
+  // Inputs:
+  //   src -- the source vertex
+  //   dst -- the sink vertex
+  // Outputs:
+  //   flow        -- each edge of the graph labeled with its flow
+  //   source_side -- the source side of a minimum cut (the vertices
+  //                  reachable from src in the residual graph)
+  // Returns:
+  //   the value of the maximum flow (0 if src == dst)
+  //----------------------------------------------------------------------
+  long long max_flow(int src, int dst, Graph& flow, Set& source_side) const;
+
+  //----------------------------------------------------------------------
+  // Maximum flow using Edmonds-Karp (augmenting along shortest paths
+  // found by breadth-first search), as a baseline for max_flow. Same
+  // conditions, inputs, and outputs as max_flow.
+  //----------------------------------------------------------------------
+  long long edmonds_karp_max_flow(int src, int dst, Graph& flow, Set& source_side) const;
+
+  //----------------------------------------------------------------------
+  // Community detection with the Louvain method over the undirected
+  // view of the graph, with edge labels as weights. Each level moves
+  // vertices to the neighboring community with the best modularity
+  // gain, in parallel rounds (every vertex chooses against the previous
+  // round's communities) followed by sequential rounds once the
+  // parallel ones stop improving, and then merges each community into
+  // a single vertex for the next level.
+  //
+  // Conditions: Assumes edge labels are positive (if both u->v and
+  //             v->u exist the smaller label is used, and a self loop
+  //             counts twice toward its vertex's weighted degree).
+  //
+  // Outputs:
+  //   communities -- mapping from each graph vertex to its community
+  //                  number, where community numbers range from 0 to
+  //                  c-1 in order of each community's smallest vertex
+  //   modularity  -- the modularity of the communities
+  // Returns:
+  //   the number of communities c
+  //----------------------------------------------------------------------
+  int louvain_communities(Map& communities, double& modularity) const;
+  int louvain_communities(std::vector<int>& communities, double& modularity) const;
+
+  //----------------------------------------------------------------------
+  // The modularity of a partition of the vertices, over the same
+  // undirected weighted view as louvain_communities (0 if the graph has
+  // no edge weight).
+  //
+  // Inputs:
+  //   communities -- communities[v] is the community number of v
+  //----------------------------------------------------------------------
+  double modularity(const std::vector<int>& communities) const;
   
 private:
 
-  // helper function for directed hamiltonian recursive function
-  bool directed_hamiltonian_rec(int v, std::list<int>& path,
-                                bool discovered[]) const;
-
-  void cliques_rec(Set& p, Set& r, Set& x, std::list<Set>& cliques) const;
+  // which neighbor lists are copied by flat_adjacency
+  enum EdgeDirection {
+    OUT_EDGES, IN_EDGES, ALL_EDGES
+  };
+
+  // helper function to copy (sorted, duplicate-free) neighbor lists into
+  // flat arrays, the neighbors of v are targets[offsets[v]] up to
+  // targets[offsets[v+1]-1]
+  void flat_adjacency(EdgeDirection d, std::vector<int>& offsets,
+                      std::vector<int>& targets) const;
+
+  // helper function to number components 0 to c-1 in topological order
+  // of the component graph, given any labeling of the components
+  int topological_component_order(std::vector<int>& components) const;
+
+  // helper function to find the components (strongly connected if dir,
+  // weakly connected otherwise), their condensation, and for each
+  // component c a bitset reach[c] of the components reachable from it,
+  // including itself
+  int component_reachability(bool dir, std::vector<int>& components,
+                             std::vector<int>& offsets,
+                             std::vector<int>& targets,
+                             std::vector<std::vector<uint64_t>>& reach) const;
+
+  // helper function to split [0,n) into one contiguous range per thread
+  // and call body(start,end) on each range
+  static void parallel_for(int n, const std::function<void(int,int)>& body);
+
+  // helper function to call body(i) for each i in [0,n) with threads
+  // taking the next unclaimed i as they finish (for uneven work)
+  static void parallel_for_each(int n, const std::function<void(int)>& body);
+
+  // helper function to find a maximum matching between the v1 vertices
+  // and their neighbors (given as flat arrays) using hopcroft-karp,
+  // returns the size of the matching
+  int hopcroft_karp(const std::vector<int>& v1, const std::vector<int>& offsets,
+                    const std::vector<int>& targets, std::vector<int>& mates) const;
+
+  // helper function to find a hamiltonian path with the held-karp
+  // dynamic program (returns false and sets timed_out at the deadline)
+  bool held_karp_hamiltonian_path(std::list<int>& path, int time_limit_ms,
+                                  bool& timed_out) const;
+
+  // helper function to find a hamiltonian path by backtracking, where
+  // components lists the strongly connected components (numbered
+  // topologically) that the path must visit in order
+  bool backtracking_hamiltonian_path(const std::vector<int>& components, int c,
+                                     const std::vector<int>& starts,
+                                     std::list<int>& path, int time_limit_ms,
+                                     bool& timed_out) const;
+
+  // helper function for the pivoting bron-kerbosch recursion, calls
+  // emit for each maximal clique r extending the current r with
+  // vertices from p (and none from x), given the flat neighbor arrays
+  void cliques_rec(std::vector<int>& r, std::vector<int>& p, std::vector<int>& x,
+                   const std::vector<int>& offsets, const std::vector<int>& targets,
+                   const std::function<void(const std::vector<int>&)>& emit,
+                   int min_size = 0) const;
+
+  // helper function for the maximum clique search, grows r with the
+  // candidates p (in order) and records any larger clique in best
+  void maximum_clique_rec(std::vector<int>& r, const std::vector<int>& p,
+                          const std::vector<int>& offsets,
+                          const std::vector<int>& targets,
+                          std::vector<int>& best) const;
+
+  // helper function to order vertices by repeatedly removing a vertex
+  // of minimum remaining degree (batagelj-zaversnik bucket algorithm),
+  // also giving the core number of each vertex
+  void degeneracy_order(const std::vector<int>& offsets, const std::vector<int>& targets,
+                        std::vector<int>& order, std::vector<int>& core) const;
+
+  // helper function to copy undirected neighbor lists without self
+  // loops into flat arrays
+  void simple_adjacency(std::vector<int>& offsets, std::vector<int>& targets) const;
+
+  // helper function to build the residual network for the max flow
+  // functions: the arcs leaving v are offsets[v] up to offsets[v+1]-1,
+  // arc a goes to heads[a] with residual capacity residual[a] and
+  // reverse[a] is its reverse arc, and edge_arcs[k] is the forward arc
+  // of the k-th edge in flat_adjacency order (-1 for self loops)
+  void flow_network(std::vector<int>& offsets, std::vector<int>& heads,
+                    std::vector<int>& reverse, std::vector<long long>& residual,
+                    std::vector<int>& edge_arcs) const;
+
+  // helper function to copy the undirected neighbor lists (without
+  // self loops) into flat arrays along with the weight of each edge,
+  // where loops[v] is twice the label of v's self loop (or 0)
+  void undirected_weights(std::vector<int>& offsets, std::vector<int>& targets,
+                          std::vector<double>& weights,
+                          std::vector<double>& loops) const;
+
+  // helper function for the modularity of a partition of a weighted
+  // graph in the layout of undirected_weights
+  static double partition_modularity(const std::vector<int>& offsets,
+                                     const std::vector<int>& targets,
+                                     const std::vector<double>& weights,
+                                     const std::vector<double>& loops,
+                                     const std::vector<int>& communities);
+
+  // helper function for a heap-based dijkstra from src to dst over flat
+  // arrays (weights[a] is the weight of the edge to targets[a]) that
+  // skips every vertex v with vertex_mask[v] set and every edge a with
+  // arc_mask[a] set, returns false if dst cannot be reached
+  static bool masked_dijkstra(int src, int dst, const std::vector<int>& offsets,
+                              const std::vector<int>& targets,
+                              const std::vector<int>& weights,
+                              const std::vector<char>& vertex_mask,
+                              const std::vector<char>& arc_mask,
+                              std::vector<int>& path, long long& cost);
+
+  // helper function to copy the per-edge flows and the minimum cut out
+  // of a residual network built by flow_network
+  void flow_result(int src, const std::vector<int>& offsets,
+                   const std::vector<int>& heads, const std::vector<int>& reverse,
+                   const std::vector<long long>& residual,
+                   const std::vector<int>& edge_arcs, Graph& flow,
+                   Set& source_side) const;
+
+  // helper function to copy the common elements of two sorted ranges
+  // into common (with room for the shorter range) and return how many
+  // there are, galloping through the longer range when the sizes are
+  // lopsided
+  static int sorted_intersection(const int* a, int a_size, const int* b, int b_size,
+                                 int* common);
+
+  // helper function to add the brandes dependencies of each source in
+  // sources (unweighted if weights is empty, where weights[k] is the
+  // weight of the edge to targets[k]) into centrality
+  void brandes_dependencies(const std::vector<int>& sources,
+                            const std::vector<int>& offsets,
+                            const std::vector<int>& targets,
+                            const std::vector<int>& weights,
+                            std::vector<double>& centrality) const;
   
   void sort_edges_by_weight(std::tuple<int,int,int> edges[], int start, int end) const ;
 
@@ -11,10 +11,16 @@
 #include <list>
 #include <set>
 #include <vector>
+#include <sstream>
 #include <gtest/gtest.h>
 #include "graph.h"
 #include "adjacency_list.h"
 #include "adjacency_matrix.h"
+#include "connectivity_tracker.h"
+#include "reachability_index.h"
+#include "dynamic_topological_order.h"
+#include "distance_oracle.h"
+#include "path_query_engine.h"
 
 
 using namespace std;
@@ -205,6 +211,833 @@ TEST(AdjacencyListTest, LargerAllPairsShortestPaths){
   ASSERT_EQ(std::numeric_limits<int>::max(), weights[7][5]);
 }
 
+//multi-source bfs distances match single-source shortest paths
+TEST(AdjacencyListTest, MultiSourceBFS){
+  AdjacencyList g(7);
+  g.set_edge(0, 0, 1);
+  g.set_edge(1, 0, 2);
+  g.set_edge(2, 0, 0);
+  g.set_edge(2, 0, 3);
+  g.set_edge(3, 0, 4);
+  g.set_edge(5, 0, 4);
+  vector<int> sources = {0, 1, 2, 3, 4, 5, 6};
+  vector<vector<int>> dist;
+  g.multi_source_bfs(true, sources, dist);
+  ASSERT_EQ(7, dist.size());
+  for (int i = 0; i < 7; ++i) {
+    for (int v = 0; v < 7; ++v) {
+      if (i == v) {
+        ASSERT_EQ(0, dist[i][v]);
+        continue;
+      }
+      list<int> path;
+      g.shortest_path_length(true, i, v, path);
+      ASSERT_EQ((int)path.size() - 1, dist[i][v]);
+    }
+  }
+  // undirected
+  g.multi_source_bfs(false, sources, dist);
+  ASSERT_EQ(3, dist[4][1]);
+  ASSERT_EQ(2, dist[5][3]);
+  ASSERT_EQ(-1, dist[0][6]);
+}
+
+//bidirectional search finds shortest paths in both directions
+TEST(AdjacencyListTest, ShortestPathLengthBidirectional){
+  AdjacencyList g(8);
+  g.set_edge(0, 0, 1);
+  g.set_edge(1, 0, 2);
+  g.set_edge(2, 0, 3);
+  g.set_edge(3, 0, 4);
+  g.set_edge(0, 0, 5);
+  g.set_edge(5, 0, 4);
+  g.set_edge(6, 0, 0);
+  list<int> path;
+  g.shortest_path_length(true, 0, 4, path);
+  ASSERT_EQ(list<int>({0, 5, 4}), path);
+  g.shortest_path_length(true, 0, 1, path);
+  ASSERT_EQ(list<int>({0, 1}), path);
+  g.shortest_path_length(true, 4, 0, path);
+  ASSERT_EQ(true, path.empty());
+  g.shortest_path_length(true, 0, 7, path);
+  ASSERT_EQ(true, path.empty());
+  g.shortest_path_length(false, 4, 6, path);
+  ASSERT_EQ(list<int>({4, 5, 0, 6}), path);
+  g.shortest_path_length(true, 6, 3, path);
+  ASSERT_EQ(5, path.size());
+  ASSERT_EQ(6, path.front());
+  ASSERT_EQ(3, path.back());
+}
+
+//union-find components match bfs components
+TEST(AdjacencyListTest, UnionFindConnectedComponents){
+  AdjacencyList g(9);
+  g.set_edge(4, 0, 0);
+  g.set_edge(1, 0, 6);
+  g.set_edge(6, 0, 3);
+  g.set_edge(8, 0, 2);
+  g.set_edge(2, 0, 5);
+  g.set_edge(7, 0, 5);
+  Map expected;
+  g.bfs_connected_components(expected);
+  Map components;
+  ASSERT_EQ(3, g.union_find_connected_components(components));
+  ASSERT_EQ(9, components.size());
+  for (int i = 0; i < 9; ++i)
+    ASSERT_EQ(expected[i], components[i]);
+  vector<int> dense;
+  ASSERT_EQ(3, g.union_find_connected_components(dense));
+  ASSERT_EQ(vector<int>({0, 1, 2, 1, 0, 2, 1, 2, 2}), dense);
+}
+
+//connectivity is tracked through edge inserts and removals
+TEST(AdjacencyListTest, ConnectivityTracker){
+  AdjacencyList g(6);
+  g.set_edge(0, 0, 1);
+  ConnectivityTracker t(g);
+  ASSERT_EQ(5, t.component_count());
+  t.set_edge(2, 0, 1);
+  t.set_edge(4, 0, 3);
+  ASSERT_EQ(3, t.component_count());
+  ASSERT_EQ(true, t.connected(0, 2));
+  ASSERT_EQ(false, t.connected(0, 3));
+  t.set_edge(3, 5, 2);
+  ASSERT_EQ(true, t.connected(0, 4));
+  ASSERT_EQ(true, g.has_edge(3, 2));
+  ASSERT_EQ(4, t.edge_count());
+  t.remove_edge(1, 2);
+  ASSERT_EQ(2, t.component_count());
+  t.remove_edge(2, 1);
+  ASSERT_EQ(3, t.component_count());
+  ASSERT_EQ(false, t.connected(0, 4));
+  ASSERT_EQ(true, t.connected(2, 4));
+  t.set_edge(5, 0, 0);
+  ASSERT_EQ(2, t.component_count());
+  ASSERT_EQ(true, t.connected(5, 1));
+}
+
+//tarjan and parallel coloring scc agree and number topologically
+TEST(AdjacencyListTest, StronglyConnectedComponents){
+  AdjacencyList g(8);
+  g.set_edge(0, 0, 1);
+  g.set_edge(1, 0, 2);
+  g.set_edge(2, 0, 0);
+  g.set_edge(2, 0, 3);
+  g.set_edge(3, 0, 4);
+  g.set_edge(4, 0, 3);
+  g.set_edge(5, 0, 4);
+  g.set_edge(6, 0, 5);
+  g.set_edge(5, 0, 6);
+  g.set_edge(7, 0, 0);
+  Map scc;
+  g.strongly_connected_components(scc);
+  vector<int> parallel;
+  ASSERT_EQ(4, g.parallel_strongly_connected_components(parallel));
+  ASSERT_EQ(8, scc.size());
+  for (int u = 0; u < 8; ++u) {
+    ASSERT_LE(0, scc[u]);
+    ASSERT_GT(4, scc[u]);
+    for (int v = 0; v < 8; ++v) {
+      ASSERT_EQ(scc[u] == scc[v], parallel[u] == parallel[v]);
+      if (g.has_edge(u, v)) {
+        ASSERT_LE(scc[u], scc[v]);
+        ASSERT_LE(parallel[u], parallel[v]);
+      }
+    }
+  }
+  ASSERT_EQ(scc[0], scc[2]);
+  ASSERT_EQ(scc[3], scc[4]);
+  ASSERT_EQ(scc[5], scc[6]);
+  ASSERT_NE(scc[2], scc[3]);
+  ASSERT_NE(scc[7], scc[0]);
+}
+
+//bitset closure matches the naive closure
+TEST(AdjacencyListTest, BitsetTransitiveClosure){
+  AdjacencyList g(7);
+  g.set_edge(0, 0, 1);
+  g.set_edge(1, 0, 2);
+  g.set_edge(2, 0, 1);
+  g.set_edge(2, 0, 3);
+  g.set_edge(4, 0, 3);
+  g.set_edge(5, 0, 6);
+  for (int dir = 0; dir < 2; ++dir) {
+    AdjacencyList expected(g);
+    g.unweighted_transitive_closure(dir, expected);
+    AdjacencyList closed(g);
+    g.bitset_transitive_closure(dir, closed);
+    vector<vector<uint64_t>> reachable;
+    g.bitset_transitive_closure(dir, reachable);
+    ASSERT_EQ(expected.edge_count(), closed.edge_count());
+    for (int u = 0; u < 7; ++u) {
+      for (int v = 0; v < 7; ++v) {
+        ASSERT_EQ(expected.has_edge(u, v), closed.has_edge(u, v));
+        bool bit = (reachable[u][v / 64] >> (v % 64)) & 1;
+        ASSERT_EQ(u != v && expected.has_edge(u, v), bit);
+      }
+    }
+  }
+  vector<vector<uint64_t>> reachable;
+  g.bitset_transitive_closure(true, reachable);
+  ASSERT_EQ(uint64_t(0x0E), reachable[0][0]);
+  ASSERT_EQ(uint64_t(0x0C), reachable[1][0]);
+  ASSERT_EQ(uint64_t(0x00), reachable[3][0]);
+}
+
+//reduction keeps component cycles and only irreducible component edges
+TEST(AdjacencyListTest, TransitiveReduction){
+  AdjacencyList g(7);
+  g.set_edge(0, 0, 1);
+  g.set_edge(1, 0, 0);
+  g.set_edge(0, 0, 2);
+  g.set_edge(1, 0, 3);
+  g.set_edge(2, 0, 3);
+  g.set_edge(3, 0, 4);
+  g.set_edge(4, 0, 5);
+  g.set_edge(5, 0, 3);
+  g.set_edge(2, 0, 5);
+  g.set_edge(0, 0, 6);
+  g.set_edge(2, 0, 6);
+  AdjacencyList reduced(7);
+  g.transitive_reduction(reduced);
+  ASSERT_EQ(8, reduced.edge_count());
+  ASSERT_EQ(true, reduced.has_edge(0, 1));
+  ASSERT_EQ(true, reduced.has_edge(1, 0));
+  ASSERT_EQ(true, reduced.has_edge(0, 2));
+  ASSERT_EQ(true, reduced.has_edge(2, 3));
+  ASSERT_EQ(true, reduced.has_edge(2, 6));
+  ASSERT_EQ(true, reduced.has_edge(3, 4));
+  ASSERT_EQ(true, reduced.has_edge(4, 5));
+  ASSERT_EQ(true, reduced.has_edge(5, 3));
+}
+
+//reachability index agrees with the transitive closure, before and
+//after being saved and loaded
+TEST(AdjacencyListTest, ReachabilityIndex){
+  AdjacencyList g(10);
+  g.set_edge(0, 0, 1);
+  g.set_edge(1, 0, 2);
+  g.set_edge(2, 0, 1);
+  g.set_edge(0, 0, 3);
+  g.set_edge(3, 0, 4);
+  g.set_edge(2, 0, 4);
+  g.set_edge(4, 0, 5);
+  g.set_edge(6, 0, 5);
+  g.set_edge(6, 0, 7);
+  g.set_edge(8, 0, 3);
+  ReachabilityIndex index(g);
+  stringstream stream;
+  index.save(stream);
+  ReachabilityIndex loaded;
+  ASSERT_EQ(true, loaded.load(stream));
+  ASSERT_EQ(10, loaded.vertex_count());
+  AdjacencyList closed(g);
+  g.unweighted_transitive_closure(true, closed);
+  for (int u = 0; u < 10; ++u) {
+    for (int v = 0; v < 10; ++v) {
+      bool expected = u == v || closed.has_edge(u, v);
+      ASSERT_EQ(expected, index.reachable(u, v));
+      ASSERT_EQ(expected, loaded.reachable(u, v));
+    }
+  }
+  stringstream bad("3 2 1");
+  ASSERT_EQ(false, loaded.load(bad));
+  // offsets that step backwards are rejected and the index is kept
+  stringstream backwards("1 2 1 0  0  0 2 1  1  0 0 1 1");
+  ASSERT_EQ(false, loaded.load(backwards));
+  ASSERT_EQ(10, loaded.vertex_count());
+  ASSERT_EQ(true, loaded.reachable(0, 5));
+}
+
+//kahn sort orders every edge forward and detects cycles
+TEST(AdjacencyListTest, KahnTopologicalSort){
+  AdjacencyList g(6);
+  g.set_edge(5, 0, 2);
+  g.set_edge(5, 0, 0);
+  g.set_edge(4, 0, 0);
+  g.set_edge(4, 0, 1);
+  g.set_edge(2, 0, 3);
+  g.set_edge(3, 0, 1);
+  Map ordering;
+  ASSERT_EQ(true, g.kahn_topological_sort(ordering));
+  ASSERT_EQ(6, ordering.size());
+  Set positions;
+  for (int u = 0; u < 6; ++u) {
+    positions.insert(ordering[u]);
+    for (int v = 0; v < 6; ++v)
+      if (g.has_edge(u, v))
+        ASSERT_LT(ordering[u], ordering[v]);
+  }
+  ASSERT_EQ(Set({1, 2, 3, 4, 5, 6}), positions);
+  g.set_edge(1, 0, 2);
+  ordering.clear();
+  ASSERT_EQ(false, g.kahn_topological_sort(ordering));
+  ASSERT_EQ(3, ordering.size());
+}
+
+//order is maintained as edges are added and cycles are reported
+TEST(AdjacencyListTest, DynamicTopologicalOrder){
+  AdjacencyList g(5);
+  g.set_edge(0, 0, 1);
+  DynamicTopologicalOrder t(g);
+  t.set_edge(3, 0, 2);
+  t.set_edge(2, 0, 0);
+  t.set_edge(1, 0, 4);
+  t.set_edge(3, 0, 4);
+  Map ordering;
+  ASSERT_EQ(true, t.topological_order(ordering));
+  for (int u = 0; u < 5; ++u)
+    for (int v = 0; v < 5; ++v)
+      if (g.has_edge(u, v))
+        ASSERT_LT(ordering[u], ordering[v]);
+  ASSERT_LT(t.order(3), t.order(2));
+  ASSERT_LT(t.order(2), t.order(0));
+  // rejected edge leaves the graph unchanged
+  ASSERT_EQ(false, t.try_set_edge(4, 0, 3));
+  ASSERT_EQ(false, g.has_edge(4, 3));
+  ASSERT_EQ(false, t.try_set_edge(4, 0, 2));
+  ASSERT_EQ(false, t.try_set_edge(4, 0, 1));
+  ASSERT_EQ(true, t.try_set_edge(0, 0, 4));
+  ASSERT_EQ(true, t.acyclic());
+  // forced cycle, then removed again
+  t.set_edge(4, 0, 3);
+  ASSERT_EQ(true, g.has_edge(4, 3));
+  ASSERT_EQ(false, t.acyclic());
+  ASSERT_EQ(-1, t.order(0));
+  t.remove_edge(4, 3);
+  ASSERT_EQ(true, t.acyclic());
+  ASSERT_LT(t.order(0), t.order(4));
+}
+
+//eulerian path uses every edge once and fails on disconnected edges
+TEST(AdjacencyListTest, DirectedEulerianPath){
+  AdjacencyList g(6);
+  g.set_edge(0, 0, 1);
+  g.set_edge(1, 0, 2);
+  g.set_edge(2, 0, 0);
+  g.set_edge(0, 0, 3);
+  g.set_edge(3, 0, 4);
+  g.set_edge(4, 0, 0);
+  g.set_edge(4, 0, 5);
+  list<int> path;
+  ASSERT_EQ(true, g.directed_eulerian_path(path));
+  ASSERT_EQ(8, path.size());
+  ASSERT_EQ(4, path.front());
+  ASSERT_EQ(5, path.back());
+  AdjacencyList used(6);
+  int prev = -1;
+  for (int v : path) {
+    if (prev != -1) {
+      ASSERT_EQ(true, g.has_edge(prev, v));
+      ASSERT_EQ(false, used.has_edge(prev, v));
+      used.set_edge(prev, 0, v);
+    }
+    prev = v;
+  }
+  // balanced but in two pieces
+  AdjacencyList h(5);
+  h.set_edge(0, 0, 1);
+  h.set_edge(1, 0, 0);
+  h.set_edge(2, 0, 3);
+  h.set_edge(3, 0, 2);
+  path.clear();
+  ASSERT_EQ(false, h.directed_eulerian_path(path));
+  ASSERT_EQ(true, path.empty());
+  h.set_edge(1, 0, 2);
+  ASSERT_EQ(true, h.directed_eulerian_path(path));
+  ASSERT_EQ(list<int>({1, 0, 1, 2, 3, 2}), path);
+  h.set_edge(4, 0, 3);
+  path.clear();
+  ASSERT_EQ(false, h.directed_eulerian_path(path));
+}
+
+//hamiltonian paths from the dynamic program and from backtracking
+TEST(AdjacencyListTest, DirectedHamiltonianPath){
+  AdjacencyList g(5);
+  g.set_edge(0, 0, 2);
+  g.set_edge(2, 0, 1);
+  g.set_edge(1, 0, 0);
+  g.set_edge(1, 0, 3);
+  g.set_edge(3, 0, 4);
+  list<int> path;
+  ASSERT_EQ(true, g.directed_hamiltonian_path(path));
+  ASSERT_EQ(list<int>({0, 2, 1, 3, 4}), path);
+  // two vertices without outgoing edges
+  g.set_edge(0, 0, 4);
+  AdjacencyList h(g);
+  h.remove_edge(3, 4);
+  path.clear();
+  ASSERT_EQ(false, h.directed_hamiltonian_path(path));
+  // too large for the dynamic program: a ring with chords
+  int n = Graph::held_karp_max_vertices + 6;
+  AdjacencyList big(n);
+  for (int i = 0; i < n; ++i) {
+    big.set_edge(i, 0, (i + 1) % n);
+    big.set_edge(i, 0, (i + 3) % n);
+  }
+  big.remove_edge(n - 1, 0);
+  path.clear();
+  bool timed_out = true;
+  ASSERT_EQ(true, big.directed_hamiltonian_path(path, 5000, timed_out));
+  ASSERT_EQ(false, timed_out);
+  ASSERT_EQ(n, path.size());
+  int prev = -1;
+  Set seen;
+  for (int v : path) {
+    if (prev != -1)
+      ASSERT_EQ(true, big.has_edge(prev, v));
+    seen.insert(v);
+    prev = v;
+  }
+  ASSERT_EQ(n, seen.size());
+}
+
+//hopcroft-karp finds a maximum matching
+TEST(AdjacencyListTest, BipartiteGraphMatching){
+  AdjacencyList g(8);
+  g.set_edge(0, 0, 1);
+  g.set_edge(0, 0, 3);
+  g.set_edge(2, 0, 1);
+  g.set_edge(4, 0, 3);
+  g.set_edge(4, 0, 5);
+  g.set_edge(6, 0, 5);
+  g.set_edge(7, 0, 6);
+  AdjacencyList matched(8);
+  ASSERT_EQ(true, g.bipartite_graph_matching(matched));
+  ASSERT_EQ(4, matched.edge_count());
+  Set covered;
+  for (int u = 0; u < 8; ++u) {
+    list<int> adj;
+    matched.connected_to(u, adj);
+    for (int v : adj) {
+      ASSERT_EQ(true, g.has_edge(u, v) || g.has_edge(v, u));
+      ASSERT_EQ(0, covered.count(u));
+      ASSERT_EQ(0, covered.count(v));
+      covered.insert(u);
+      covered.insert(v);
+    }
+  }
+  g.set_edge(2, 0, 0);
+  AdjacencyList odd(8);
+  ASSERT_EQ(false, g.bipartite_graph_matching(odd));
+}
+
+//auction finds the minimum cost assignment
+TEST(AdjacencyListTest, MinCostBipartiteAssignment){
+  AdjacencyList g(6);
+  // jobs 0,2,4 (color 1) and workers 1,3,5 (color 0)
+  g.set_edge(0, 4, 1);
+  g.set_edge(0, 1, 3);
+  g.set_edge(0, 3, 5);
+  g.set_edge(2, 2, 1);
+  g.set_edge(2, 0, 3);
+  g.set_edge(2, 5, 5);
+  g.set_edge(4, 3, 1);
+  g.set_edge(5, 2, 4);
+  g.set_edge(4, 2, 3);
+  AdjacencyList assignment(6);
+  long long cost = -1;
+  ASSERT_EQ(true, g.min_cost_bipartite_assignment(assignment, cost));
+  ASSERT_EQ(5, cost);
+  ASSERT_EQ(3, assignment.edge_count());
+  ASSERT_EQ(true, assignment.has_edge(3, 0));
+  ASSERT_EQ(true, assignment.has_edge(1, 2));
+  ASSERT_EQ(true, assignment.has_edge(5, 4));
+  // no perfect matching
+  AdjacencyList h(6);
+  h.set_edge(1, 1, 0);
+  h.set_edge(3, 1, 0);
+  h.set_edge(2, 1, 5);
+  h.set_edge(4, 1, 5);
+  AdjacencyList none(6);
+  ASSERT_EQ(false, h.min_cost_bipartite_assignment(none, cost));
+}
+
+//pivoting bron-kerbosch finds each maximal clique once
+TEST(AdjacencyListTest, MaximalCliques){
+  AdjacencyList g(8);
+  g.set_edge(0, 0, 1);
+  g.set_edge(1, 0, 2);
+  g.set_edge(2, 0, 0);
+  g.set_edge(0, 0, 3);
+  g.set_edge(3, 0, 1);
+  g.set_edge(3, 0, 2);
+  g.set_edge(2, 0, 4);
+  g.set_edge(4, 0, 5);
+  g.set_edge(5, 0, 2);
+  g.set_edge(6, 0, 5);
+  g.set_edge(6, 0, 6);
+  list<Set> found;
+  g.cliques(found);
+  set<Set> cliques(found.begin(), found.end());
+  ASSERT_EQ(4, found.size());
+  ASSERT_EQ(set<Set>({{0, 1, 2, 3}, {2, 4, 5}, {5, 6}, {7}}), cliques);
+}
+
+//streamed cliques match the stored ones and the largest is found
+TEST(AdjacencyListTest, StreamingAndMaximumClique){
+  AdjacencyList g(8);
+  g.set_edge(0, 0, 1);
+  g.set_edge(1, 0, 2);
+  g.set_edge(2, 0, 0);
+  g.set_edge(0, 0, 3);
+  g.set_edge(3, 0, 1);
+  g.set_edge(3, 0, 2);
+  g.set_edge(2, 0, 4);
+  g.set_edge(4, 0, 5);
+  g.set_edge(5, 0, 2);
+  g.set_edge(6, 0, 5);
+  set<Set> streamed;
+  g.cliques(0, [&](const Set& c) { streamed.insert(c); });
+  list<Set> stored;
+  g.cliques(stored);
+  ASSERT_EQ(set<Set>(stored.begin(), stored.end()), streamed);
+  streamed.clear();
+  g.cliques(3, [&](const Set& c) { streamed.insert(c); });
+  ASSERT_EQ(set<Set>({{0, 1, 2, 3}, {2, 4, 5}}), streamed);
+  Set largest;
+  g.maximum_clique(largest);
+  ASSERT_EQ(Set({0, 1, 2, 3}), largest);
+  AdjacencyList empty(3);
+  largest.clear();
+  empty.maximum_clique(largest);
+  ASSERT_EQ(1, largest.size());
+}
+
+//independent set over a forest with vertices in any order
+TEST(AdjacencyListTest, ForestMaxIndependentSet){
+  AdjacencyList g(9);
+  // tree rooted anywhere: 3 - 0 - 5, 0 - 7, 7 - 2
+  g.set_edge(3, 0, 0);
+  g.set_edge(0, 0, 5);
+  g.set_edge(7, 0, 0);
+  g.set_edge(2, 0, 7);
+  // path 8 - 1 - 6, and 4 alone
+  g.set_edge(1, 0, 8);
+  g.set_edge(1, 0, 6);
+  int weights[9] = {10, 5, 1, 3, 2, 4, 3, 9, 3};
+  Set S;
+  ASSERT_EQ(true, g.forest_max_independent_set(weights, S));
+  ASSERT_EQ(Set({3, 5, 7, 4, 8, 6}), S);
+  vector<bool> in_set;
+  long long total = 0;
+  ASSERT_EQ(true, g.forest_max_independent_set(weights, in_set, total));
+  ASSERT_EQ(24, total);
+  // cycle is not a forest
+  g.set_edge(5, 0, 3);
+  ASSERT_EQ(false, g.forest_max_independent_set(weights, in_set, total));
+}
+
+//path graph too long for a stack-allocated table
+TEST(AdjacencyListTest, LongPathMaxIndependentSet){
+  int n = 200000;
+  AdjacencyList g(n);
+  vector<int> weights(n, 1000000);
+  for (int i = 1; i < n; ++i)
+    g.set_edge(i - 1, 0, i);
+  Set S;
+  ASSERT_EQ(true, g.path_max_independent_set(weights.data(), S));
+  ASSERT_EQ(n / 2, S.size());
+  vector<bool> in_set;
+  long long total = 0;
+  ASSERT_EQ(true, g.forest_max_independent_set(weights.data(), in_set, total));
+  ASSERT_EQ(100000000000LL, total);
+}
+
+//betweenness on a path, a star, and a weighted detour
+TEST(AdjacencyListTest, BetweennessCentrality){
+  // undirected path 0 - 1 - 2 - 3
+  AdjacencyList g1(4);
+  g1.set_edge(0, 0, 1);
+  g1.set_edge(2, 0, 1);
+  g1.set_edge(2, 0, 3);
+  vector<double> c;
+  g1.betweenness_centrality(false, false, c);
+  ASSERT_EQ(vector<double>({0, 2, 2, 0}), c);
+  // directed, only 0 -> 1 -> 2 -> 3 passes through the middle
+  g1.set_edge(1, 0, 2);
+  g1.betweenness_centrality(true, false, c);
+  ASSERT_EQ(vector<double>({0, 2, 2, 0}), c);
+  // two equal routes 0 -> 1 -> 3 and 0 -> 2 -> 3 split the pair
+  AdjacencyList g2(4);
+  g2.set_edge(0, 1, 1);
+  g2.set_edge(1, 1, 3);
+  g2.set_edge(0, 1, 2);
+  g2.set_edge(2, 1, 3);
+  g2.betweenness_centrality(true, false, c);
+  ASSERT_EQ(vector<double>({0, 0.5, 0.5, 0}), c);
+  // a heavy edge on 1 -> 3 sends the weighted path through 2
+  g2.set_edge(1, 5, 3);
+  g2.betweenness_centrality(true, true, c);
+  ASSERT_EQ(vector<double>({0, 0, 1, 0}), c);
+}
+
+//sampled betweenness is exact with every source and within its bound
+TEST(AdjacencyListTest, ApproximateBetweennessCentrality){
+  AdjacencyList g(6);
+  for (int i = 1; i < 6; ++i)
+    g.set_edge(0, 0, i);
+  vector<double> exact;
+  g.betweenness_centrality(false, false, exact);
+  ASSERT_EQ(10, exact[0]);
+  vector<double> c;
+  ASSERT_EQ(0, g.approximate_betweenness_centrality(false, false, 6, 1, c));
+  ASSERT_EQ(exact, c);
+  double bound = g.approximate_betweenness_centrality(false, false, 3, 1, c);
+  ASSERT_LT(0, bound);
+  for (int v = 0; v < 6; ++v)
+    ASSERT_LE(std::abs(c[v] - exact[v]), bound);
+}
+
+//pagerank on a cycle, a sink, and a personalized batch
+TEST(AdjacencyListTest, PageRank){
+  // a directed cycle ranks every vertex equally
+  AdjacencyList g1(4);
+  for (int i = 0; i < 4; ++i)
+    g1.set_edge(i, 0, (i + 1) % 4);
+  vector<double> ranks;
+  ASSERT_EQ(1, g1.pagerank(0.85, 1e-10, 100, ranks));
+  for (int v = 0; v < 4; ++v)
+    ASSERT_NEAR(0.25, ranks[v], 1e-12);
+  // everything points at 0, which has no out edges
+  AdjacencyList g2(3);
+  g2.set_edge(1, 0, 0);
+  g2.set_edge(2, 0, 0);
+  int iterations = g2.pagerank(0.85, 1e-12, 1000, ranks);
+  ASSERT_LT(1, iterations);
+  ASSERT_GT(1000, iterations);
+  ASSERT_NEAR(1.0, ranks[0] + ranks[1] + ranks[2], 1e-9);
+  ASSERT_GT(ranks[0], ranks[1]);
+  ASSERT_NEAR(ranks[1], ranks[2], 1e-12);
+  // restart at 1 only: 2 is never visited
+  vector<vector<double>> batch;
+  ASSERT_LT(0, g2.personalized_pagerank(0.85, 1e-12, 1000,
+                                        {{1, 1, 1}, {0, 2, 0}}, batch));
+  ASSERT_EQ(2, batch.size());
+  for (int v = 0; v < 3; ++v)
+    ASSERT_NEAR(ranks[v], batch[0][v], 1e-9);
+  ASSERT_NEAR(0.0, batch[1][2], 1e-12);
+  ASSERT_NEAR(1.0, batch[1][0] + batch[1][1], 1e-9);
+  ASSERT_EQ(-1, g2.personalized_pagerank(0.85, 1e-12, 1000, {{0, 0, 0}}, batch));
+}
+
+//triangles, clustering, and transitivity of two triangles sharing an edge
+TEST(AdjacencyListTest, TriangleCount){
+  AdjacencyList g(5);
+  g.set_edge(0, 0, 1);
+  g.set_edge(1, 0, 2);
+  g.set_edge(2, 0, 0);
+  g.set_edge(3, 0, 1);
+  g.set_edge(2, 0, 3);
+  g.set_edge(3, 0, 4);
+  g.set_edge(4, 0, 4);
+  vector<long long> triangles;
+  ASSERT_EQ(2, g.triangle_count(triangles));
+  ASSERT_EQ(vector<long long>({1, 2, 2, 1, 0}), triangles);
+  vector<double> coefficients;
+  g.local_clustering_coefficients(coefficients);
+  ASSERT_NEAR(1.0, coefficients[0], 1e-12);
+  ASSERT_NEAR(2.0 / 3, coefficients[1], 1e-12);
+  ASSERT_NEAR(1.0 / 3, coefficients[3], 1e-12);
+  ASSERT_EQ(0, coefficients[4]);
+  // 6 triangle corners over 1 + 3 + 3 + 3 + 0 triples
+  ASSERT_NEAR(0.6, g.transitivity(), 1e-12);
+  AdjacencyList empty(3);
+  ASSERT_EQ(0, empty.triangle_count());
+  ASSERT_EQ(0, empty.transitivity());
+}
+
+//core numbers of a 4-clique with a tail, and its 3-core
+TEST(AdjacencyListTest, CoreDecomposition){
+  AdjacencyList g(6);
+  for (int u = 0; u < 4; ++u)
+    for (int v = u + 1; v < 4; ++v)
+      g.set_edge(u, 0, v);
+  g.set_edge(3, 0, 4);
+  g.set_edge(4, 0, 5);
+  g.set_edge(5, 0, 5);
+  vector<int> core;
+  vector<int> order;
+  ASSERT_EQ(3, g.core_decomposition(core, order));
+  ASSERT_EQ(vector<int>({3, 3, 3, 3, 1, 1}), core);
+  ASSERT_EQ(6, order.size());
+  vector<int> parallel_core;
+  ASSERT_EQ(3, g.parallel_core_decomposition(parallel_core));
+  ASSERT_EQ(core, parallel_core);
+  AdjacencyList core_graph(6);
+  ASSERT_EQ(4, g.k_core(3, core_graph));
+  ASSERT_EQ(6, core_graph.edge_count());
+  ASSERT_EQ(false, core_graph.has_edge(3, 4));
+}
+
+//max flow and min cut on the classic six vertex network
+TEST(AdjacencyListTest, MaxFlow){
+  AdjacencyList g(6);
+  g.set_edge(0, 16, 1);
+  g.set_edge(0, 13, 2);
+  g.set_edge(1, 12, 3);
+  g.set_edge(2, 4, 1);
+  g.set_edge(2, 14, 4);
+  g.set_edge(3, 9, 2);
+  g.set_edge(3, 20, 5);
+  g.set_edge(4, 7, 3);
+  g.set_edge(4, 4, 5);
+  AdjacencyList flow(6);
+  Set source_side;
+  ASSERT_EQ(23, g.max_flow(0, 5, flow, source_side));
+  ASSERT_EQ(9, flow.edge_count());
+  int f = 0;
+  flow.get_edge(3, 5, f);
+  ASSERT_EQ(19, f);
+  flow.get_edge(4, 5, f);
+  ASSERT_EQ(4, f);
+  ASSERT_EQ(Set({0, 1, 2, 4}), source_side);
+  AdjacencyList baseline(6);
+  Set baseline_side;
+  ASSERT_EQ(23, g.edmonds_karp_max_flow(0, 5, baseline, baseline_side));
+  ASSERT_EQ(source_side, baseline_side);
+  // no path back to the source
+  AdjacencyList none(6);
+  source_side.clear();
+  ASSERT_EQ(0, g.max_flow(5, 0, none, source_side));
+  ASSERT_EQ(Set({5}), source_side);
+}
+
+//louvain splits two cliques joined by a single edge
+TEST(AdjacencyListTest, LouvainCommunities){
+  AdjacencyList g(8);
+  for (int u = 0; u < 4; ++u) {
+    for (int v = u + 1; v < 4; ++v) {
+      g.set_edge(u, 1, v);
+      g.set_edge(u + 4, 1, v + 4);
+    }
+  }
+  g.set_edge(3, 1, 4);
+  Map communities;
+  double modularity = 0;
+  ASSERT_EQ(2, g.louvain_communities(communities, modularity));
+  for (int v = 0; v < 8; ++v)
+    ASSERT_EQ(v < 4 ? 0 : 1, communities[v]);
+  // 12 of the 13 edges are internal, and each side has degree 13
+  ASSERT_NEAR(12.0 / 13 - 0.5, modularity, 1e-12);
+  vector<int> dense;
+  ASSERT_EQ(2, g.louvain_communities(dense, modularity));
+  ASSERT_NEAR(modularity, g.modularity(dense), 1e-12);
+  ASSERT_NEAR(0.0, g.modularity(vector<int>(8, 0)), 1e-12);
+  // no edges leaves every vertex alone
+  AdjacencyList empty(3);
+  ASSERT_EQ(3, empty.louvain_communities(dense, modularity));
+  ASSERT_EQ(0, modularity);
+}
+
+//landmark bounds on a weighted path with a branch
+TEST(AdjacencyListTest, DistanceOracle){
+  // 0 - 1 - 2 - 3 - 4 with 5 hanging off 2, and 6 alone
+  AdjacencyList g(7);
+  g.set_edge(0, 2, 1);
+  g.set_edge(1, 3, 2);
+  g.set_edge(2, 1, 3);
+  g.set_edge(3, 4, 4);
+  g.set_edge(5, 2, 2);
+  DistanceOracle oracle(g, 1, false, true);
+  ASSERT_EQ(1, oracle.landmark_count());
+  long long lower = 0;
+  long long upper = 0;
+  // 2 is the only vertex with three edges, so it is the landmark
+  ASSERT_EQ(true, oracle.distance_bounds(0, 4, lower, upper));
+  ASSERT_EQ(0, lower);
+  ASSERT_EQ(10, upper);
+  ASSERT_EQ(true, oracle.distance_bounds(2, 4, lower, upper));
+  ASSERT_EQ(5, lower);
+  ASSERT_EQ(5, upper);
+  ASSERT_EQ(false, oracle.distance_bounds(0, 6, lower, upper));
+  stringstream stream;
+  oracle.save(stream);
+  DistanceOracle loaded;
+  ASSERT_EQ(true, loaded.load(stream));
+  ASSERT_EQ(7, loaded.vertex_count());
+  ASSERT_EQ(true, loaded.distance_bounds(5, 1, lower, upper));
+  ASSERT_EQ(1, lower);
+  ASSERT_EQ(5, upper);
+  // directed, only forward paths count
+  DistanceOracle directed(g, 2, true, false);
+  ASSERT_EQ(true, directed.distance_bounds(0, 4, lower, upper));
+  ASSERT_LE(lower, 4);
+  ASSERT_EQ(4, upper);
+  ASSERT_EQ(false, directed.distance_bounds(4, 0, lower, upper));
+  stringstream bad("2 1 0 0 5");
+  ASSERT_EQ(false, loaded.load(bad));
+  // negative distances are rejected and the oracle is kept
+  stringstream negative("2 1 0 0  0  0 -3");
+  ASSERT_EQ(false, loaded.load(negative));
+  ASSERT_EQ(7, loaded.vertex_count());
+}
+
+//yen's algorithm lists the alternative routes in order of cost
+TEST(AdjacencyListTest, KShortestPaths){
+  AdjacencyList g(6);
+  g.set_edge(0, 3, 1);
+  g.set_edge(0, 2, 2);
+  g.set_edge(1, 4, 3);
+  g.set_edge(2, 1, 1);
+  g.set_edge(2, 2, 3);
+  g.set_edge(2, 3, 4);
+  g.set_edge(3, 1, 4);
+  g.set_edge(3, 2, 5);
+  g.set_edge(4, 2, 5);
+  g.set_edge(5, 1, 0);
+  vector<list<int>> paths;
+  vector<long long> costs;
+  ASSERT_EQ(3, g.k_shortest_paths(0, 5, 3, paths, costs));
+  ASSERT_EQ(list<int>({0, 2, 3, 5}), paths[0]);
+  ASSERT_EQ(vector<long long>({6, 7, 7}), costs);
+  for (int i = 1; i < 3; ++i)
+    ASSERT_EQ(5, paths[i].back());
+  // only 7 loopless routes exist
+  ASSERT_EQ(7, g.k_shortest_paths(0, 5, 20, paths, costs));
+  ASSERT_EQ(vector<long long>({6, 7, 7, 9, 9, 10, 10}), costs);
+  ASSERT_EQ(0, g.k_shortest_paths(5, 1, 0, paths, costs));
+  ASSERT_EQ(1, g.k_shortest_paths(3, 3, 2, paths, costs));
+  ASSERT_EQ(list<int>({3}), paths[0]);
+}
+
+//a mixed batch of path queries answered on a pool of threads
+TEST(AdjacencyListTest, PathQueryEngine){
+  AdjacencyList g(5);
+  g.set_edge(0, 4, 1);
+  g.set_edge(0, 1, 2);
+  g.set_edge(2, 1, 1);
+  g.set_edge(1, 1, 3);
+  g.set_edge(4, -2, 3);
+  PathQueryEngine engine(g, true, 3);
+  ASSERT_EQ(3, engine.thread_count());
+  vector<PathQuery> queries = {{BFS_PATH, 0, 3},
+                               {DIJKSTRA_PATH, 0, 3},
+                               {BELLMAN_FORD_PATH, 4, 3},
+                               {DIJKSTRA_PATH, 3, 0},
+                               {BFS_PATH, 2, 2}};
+  vector<PathResult> results;
+  engine.run(queries, results);
+  ASSERT_EQ(5, results.size());
+  ASSERT_EQ(2, results[0].cost);
+  ASSERT_EQ(list<int>({0, 1, 3}), results[0].path);
+  ASSERT_EQ(3, results[1].cost);
+  ASSERT_EQ(list<int>({0, 2, 1, 3}), results[1].path);
+  ASSERT_EQ(true, results[2].ok);
+  ASSERT_EQ(-2, results[2].cost);
+  ASSERT_EQ(-1, results[3].cost);
+  ASSERT_EQ(true, results[3].path.empty());
+  ASSERT_EQ(list<int>({2}), results[4].path);
+  // the same engine answers later batches, a negative cycle is reported
+  g.set_edge(3, -5, 4);
+  PathQueryEngine cyclic(g, false, 2);
+  cyclic.run({{BELLMAN_FORD_PATH, 0, 3}, {BFS_PATH, 3, 0}}, results);
+  ASSERT_EQ(false, results[0].ok);
+  ASSERT_EQ(2, results[1].cost);
+  engine.run({{BFS_PATH, 3, 0}}, results);
+  ASSERT_EQ(-1, results[0].cost);
+}
+
 //----------------------------------------------------------------------
 // Adjacency Matrix Tests
 //----------------------------------------------------------------------
@@ -361,6 +1194,817 @@ TEST(AdjacencyMatrixTest, LargerAllPairsShortestPaths){
   ASSERT_EQ(std::numeric_limits<int>::max(), weights[7][5]);
 }
 
+//multi-source bfs distances match single-source shortest paths
+TEST(AdjacencyMatrixTest, MultiSourceBFS){
+  AdjacencyMatrix g(7);
+  g.set_edge(0, 0, 1);
+  g.set_edge(1, 0, 2);
+  g.set_edge(2, 0, 0);
+  g.set_edge(2, 0, 3);
+  g.set_edge(3, 0, 4);
+  g.set_edge(5, 0, 4);
+  vector<int> sources = {0, 1, 2, 3, 4, 5, 6};
+  vector<vector<int>> dist;
+  g.multi_source_bfs(true, sources, dist);
+  ASSERT_EQ(7, dist.size());
+  for (int i = 0; i < 7; ++i) {
+    for (int v = 0; v < 7; ++v) {
+      if (i == v) {
+        ASSERT_EQ(0, dist[i][v]);
+        continue;
+      }
+      list<int> path;
+      g.shortest_path_length(true, i, v, path);
+      ASSERT_EQ((int)path.size() - 1, dist[i][v]);
+    }
+  }
+  // undirected
+  g.multi_source_bfs(false, sources, dist);
+  ASSERT_EQ(3, dist[4][1]);
+  ASSERT_EQ(2, dist[5][3]);
+  ASSERT_EQ(-1, dist[0][6]);
+}
+
+//bidirectional search finds shortest paths in both directions
+TEST(AdjacencyMatrixTest, ShortestPathLengthBidirectional){
+  AdjacencyMatrix g(8);
+  g.set_edge(0, 0, 1);
+  g.set_edge(1, 0, 2);
+  g.set_edge(2, 0, 3);
+  g.set_edge(3, 0, 4);
+  g.set_edge(0, 0, 5);
+  g.set_edge(5, 0, 4);
+  g.set_edge(6, 0, 0);
+  list<int> path;
+  g.shortest_path_length(true, 0, 4, path);
+  ASSERT_EQ(list<int>({0, 5, 4}), path);
+  g.shortest_path_length(true, 0, 1, path);
+  ASSERT_EQ(list<int>({0, 1}), path);
+  g.shortest_path_length(true, 4, 0, path);
+  ASSERT_EQ(true, path.empty());
+  g.shortest_path_length(true, 0, 7, path);
+  ASSERT_EQ(true, path.empty());
+  g.shortest_path_length(false, 4, 6, path);
+  ASSERT_EQ(list<int>({4, 5, 0, 6}), path);
+  g.shortest_path_length(true, 6, 3, path);
+  ASSERT_EQ(5, path.size());
+  ASSERT_EQ(6, path.front());
+  ASSERT_EQ(3, path.back());
+}
+
+//union-find components match bfs components
+TEST(AdjacencyMatrixTest, UnionFindConnectedComponents){
+  AdjacencyMatrix g(9);
+  g.set_edge(4, 0, 0);
+  g.set_edge(1, 0, 6);
+  g.set_edge(6, 0, 3);
+  g.set_edge(8, 0, 2);
+  g.set_edge(2, 0, 5);
+  g.set_edge(7, 0, 5);
+  Map expected;
+  g.bfs_connected_components(expected);
+  Map components;
+  ASSERT_EQ(3, g.union_find_connected_components(components));
+  ASSERT_EQ(9, components.size());
+  for (int i = 0; i < 9; ++i)
+    ASSERT_EQ(expected[i], components[i]);
+  vector<int> dense;
+  ASSERT_EQ(3, g.union_find_connected_components(dense));
+  ASSERT_EQ(vector<int>({0, 1, 2, 1, 0, 2, 1, 2, 2}), dense);
+}
+
+//connectivity is tracked through edge inserts and removals
+TEST(AdjacencyMatrixTest, ConnectivityTracker){
+  AdjacencyMatrix g(6);
+  g.set_edge(0, 0, 1);
+  ConnectivityTracker t(g);
+  ASSERT_EQ(5, t.component_count());
+  t.set_edge(2, 0, 1);
+  t.set_edge(4, 0, 3);
+  ASSERT_EQ(3, t.component_count());
+  ASSERT_EQ(true, t.connected(0, 2));
+  ASSERT_EQ(false, t.connected(0, 3));
+  t.set_edge(3, 5, 2);
+  ASSERT_EQ(true, t.connected(0, 4));
+  ASSERT_EQ(true, g.has_edge(3, 2));
+  ASSERT_EQ(4, t.edge_count());
+  t.remove_edge(1, 2);
+  ASSERT_EQ(2, t.component_count());
+  t.remove_edge(2, 1);
+  ASSERT_EQ(3, t.component_count());
+  ASSERT_EQ(false, t.connected(0, 4));
+  ASSERT_EQ(true, t.connected(2, 4));
+  t.set_edge(5, 0, 0);
+  ASSERT_EQ(2, t.component_count());
+  ASSERT_EQ(true, t.connected(5, 1));
+}
+
+//tarjan and parallel coloring scc agree and number topologically
+TEST(AdjacencyMatrixTest, StronglyConnectedComponents){
+  AdjacencyMatrix g(8);
+  g.set_edge(0, 0, 1);
+  g.set_edge(1, 0, 2);
+  g.set_edge(2, 0, 0);
+  g.set_edge(2, 0, 3);
+  g.set_edge(3, 0, 4);
+  g.set_edge(4, 0, 3);
+  g.set_edge(5, 0, 4);
+  g.set_edge(6, 0, 5);
+  g.set_edge(5, 0, 6);
+  g.set_edge(7, 0, 0);
+  Map scc;
+  g.strongly_connected_components(scc);
+  vector<int> parallel;
+  ASSERT_EQ(4, g.parallel_strongly_connected_components(parallel));
+  ASSERT_EQ(8, scc.size());
+  for (int u = 0; u < 8; ++u) {
+    ASSERT_LE(0, scc[u]);
+    ASSERT_GT(4, scc[u]);
+    for (int v = 0; v < 8; ++v) {
+      ASSERT_EQ(scc[u] == scc[v], parallel[u] == parallel[v]);
+      if (g.has_edge(u, v)) {
+        ASSERT_LE(scc[u], scc[v]);
+        ASSERT_LE(parallel[u], parallel[v]);
+      }
+    }
+  }
+  ASSERT_EQ(scc[0], scc[2]);
+  ASSERT_EQ(scc[3], scc[4]);
+  ASSERT_EQ(scc[5], scc[6]);
+  ASSERT_NE(scc[2], scc[3]);
+  ASSERT_NE(scc[7], scc[0]);
+}
+
+//bitset closure matches the naive closure
+TEST(AdjacencyMatrixTest, BitsetTransitiveClosure){
+  AdjacencyMatrix g(7);
+  g.set_edge(0, 0, 1);
+  g.set_edge(1, 0, 2);
+  g.set_edge(2, 0, 1);
+  g.set_edge(2, 0, 3);
+  g.set_edge(4, 0, 3);
+  g.set_edge(5, 0, 6);
+  for (int dir = 0; dir < 2; ++dir) {
+    AdjacencyMatrix expected(g);
+    g.unweighted_transitive_closure(dir, expected);
+    AdjacencyMatrix closed(g);
+    g.bitset_transitive_closure(dir, closed);
+    vector<vector<uint64_t>> reachable;
+    g.bitset_transitive_closure(dir, reachable);
+    ASSERT_EQ(expected.edge_count(), closed.edge_count());
+    for (int u = 0; u < 7; ++u) {
+      for (int v = 0; v < 7; ++v) {
+        ASSERT_EQ(expected.has_edge(u, v), closed.has_edge(u, v));
+        bool bit = (reachable[u][v / 64] >> (v % 64)) & 1;
+        ASSERT_EQ(u != v && expected.has_edge(u, v), bit);
+      }
+    }
+  }
+  vector<vector<uint64_t>> reachable;
+  g.bitset_transitive_closure(true, reachable);
+  ASSERT_EQ(uint64_t(0x0E), reachable[0][0]);
+  ASSERT_EQ(uint64_t(0x0C), reachable[1][0]);
+  ASSERT_EQ(uint64_t(0x00), reachable[3][0]);
+}
+
+//reduction keeps component cycles and only irreducible component edges
+TEST(AdjacencyMatrixTest, TransitiveReduction){
+  AdjacencyMatrix g(7);
+  g.set_edge(0, 0, 1);
+  g.set_edge(1, 0, 0);
+  g.set_edge(0, 0, 2);
+  g.set_edge(1, 0, 3);
+  g.set_edge(2, 0, 3);
+  g.set_edge(3, 0, 4);
+  g.set_edge(4, 0, 5);
+  g.set_edge(5, 0, 3);
+  g.set_edge(2, 0, 5);
+  g.set_edge(0, 0, 6);
+  g.set_edge(2, 0, 6);
+  AdjacencyMatrix reduced(7);
+  g.transitive_reduction(reduced);
+  ASSERT_EQ(8, reduced.edge_count());
+  ASSERT_EQ(true, reduced.has_edge(0, 1));
+  ASSERT_EQ(true, reduced.has_edge(1, 0));
+  ASSERT_EQ(true, reduced.has_edge(0, 2));
+  ASSERT_EQ(true, reduced.has_edge(2, 3));
+  ASSERT_EQ(true, reduced.has_edge(2, 6));
+  ASSERT_EQ(true, reduced.has_edge(3, 4));
+  ASSERT_EQ(true, reduced.has_edge(4, 5));
+  ASSERT_EQ(true, reduced.has_edge(5, 3));
+}
+
+//reachability index agrees with the transitive closure, before and
+//after being saved and loaded
+TEST(AdjacencyMatrixTest, ReachabilityIndex){
+  AdjacencyMatrix g(10);
+  g.set_edge(0, 0, 1);
+  g.set_edge(1, 0, 2);
+  g.set_edge(2, 0, 1);
+  g.set_edge(0, 0, 3);
+  g.set_edge(3, 0, 4);
+  g.set_edge(2, 0, 4);
+  g.set_edge(4, 0, 5);
+  g.set_edge(6, 0, 5);
+  g.set_edge(6, 0, 7);
+  g.set_edge(8, 0, 3);
+  ReachabilityIndex index(g);
+  stringstream stream;
+  index.save(stream);
+  ReachabilityIndex loaded;
+  ASSERT_EQ(true, loaded.load(stream));
+  ASSERT_EQ(10, loaded.vertex_count());
+  AdjacencyMatrix closed(g);
+  g.unweighted_transitive_closure(true, closed);
+  for (int u = 0; u < 10; ++u) {
+    for (int v = 0; v < 10; ++v) {
+      bool expected = u == v || closed.has_edge(u, v);
+      ASSERT_EQ(expected, index.reachable(u, v));
+      ASSERT_EQ(expected, loaded.reachable(u, v));
+    }
+  }
+  stringstream bad("3 2 1");
+  ASSERT_EQ(false, loaded.load(bad));
+  // offsets that step backwards are rejected and the index is kept
+  stringstream backwards("1 2 1 0  0  0 2 1  1  0 0 1 1");
+  ASSERT_EQ(false, loaded.load(backwards));
+  ASSERT_EQ(10, loaded.vertex_count());
+  ASSERT_EQ(true, loaded.reachable(0, 5));
+}
+
+//kahn sort orders every edge forward and detects cycles
+TEST(AdjacencyMatrixTest, KahnTopologicalSort){
+  AdjacencyMatrix g(6);
+  g.set_edge(5, 0, 2);
+  g.set_edge(5, 0, 0);
+  g.set_edge(4, 0, 0);
+  g.set_edge(4, 0, 1);
+  g.set_edge(2, 0, 3);
+  g.set_edge(3, 0, 1);
+  Map ordering;
+  ASSERT_EQ(true, g.kahn_topological_sort(ordering));
+  ASSERT_EQ(6, ordering.size());
+  Set positions;
+  for (int u = 0; u < 6; ++u) {
+    positions.insert(ordering[u]);
+    for (int v = 0; v < 6; ++v)
+      if (g.has_edge(u, v))
+        ASSERT_LT(ordering[u], ordering[v]);
+  }
+  ASSERT_EQ(Set({1, 2, 3, 4, 5, 6}), positions);
+  g.set_edge(1, 0, 2);
+  ordering.clear();
+  ASSERT_EQ(false, g.kahn_topological_sort(ordering));
+  ASSERT_EQ(3, ordering.size());
+}
+
+//order is maintained as edges are added and cycles are reported
+TEST(AdjacencyMatrixTest, DynamicTopologicalOrder){
+  AdjacencyMatrix g(5);
+  g.set_edge(0, 0, 1);
+  DynamicTopologicalOrder t(g);
+  t.set_edge(3, 0, 2);
+  t.set_edge(2, 0, 0);
+  t.set_edge(1, 0, 4);
+  t.set_edge(3, 0, 4);
+  Map ordering;
+  ASSERT_EQ(true, t.topological_order(ordering));
+  for (int u = 0; u < 5; ++u)
+    for (int v = 0; v < 5; ++v)
+      if (g.has_edge(u, v))
+        ASSERT_LT(ordering[u], ordering[v]);
+  ASSERT_LT(t.order(3), t.order(2));
+  ASSERT_LT(t.order(2), t.order(0));
+  // rejected edge leaves the graph unchanged
+  ASSERT_EQ(false, t.try_set_edge(4, 0, 3));
+  ASSERT_EQ(false, g.has_edge(4, 3));
+  ASSERT_EQ(false, t.try_set_edge(4, 0, 2));
+  ASSERT_EQ(false, t.try_set_edge(4, 0, 1));
+  ASSERT_EQ(true, t.try_set_edge(0, 0, 4));
+  ASSERT_EQ(true, t.acyclic());
+  // forced cycle, then removed again
+  t.set_edge(4, 0, 3);
+  ASSERT_EQ(true, g.has_edge(4, 3));
+  ASSERT_EQ(false, t.acyclic());
+  ASSERT_EQ(-1, t.order(0));
+  t.remove_edge(4, 3);
+  ASSERT_EQ(true, t.acyclic());
+  ASSERT_LT(t.order(0), t.order(4));
+}
+
+//eulerian path uses every edge once and fails on disconnected edges
+TEST(AdjacencyMatrixTest, DirectedEulerianPath){
+  AdjacencyMatrix g(6);
+  g.set_edge(0, 0, 1);
+  g.set_edge(1, 0, 2);
+  g.set_edge(2, 0, 0);
+  g.set_edge(0, 0, 3);
+  g.set_edge(3, 0, 4);
+  g.set_edge(4, 0, 0);
+  g.set_edge(4, 0, 5);
+  list<int> path;
+  ASSERT_EQ(true, g.directed_eulerian_path(path));
+  ASSERT_EQ(8, path.size());
+  ASSERT_EQ(4, path.front());
+  ASSERT_EQ(5, path.back());
+  AdjacencyMatrix used(6);
+  int prev = -1;
+  for (int v : path) {
+    if (prev != -1) {
+      ASSERT_EQ(true, g.has_edge(prev, v));
+      ASSERT_EQ(false, used.has_edge(prev, v));
+      used.set_edge(prev, 0, v);
+    }
+    prev = v;
+  }
+  // balanced but in two pieces
+  AdjacencyMatrix h(5);
+  h.set_edge(0, 0, 1);
+  h.set_edge(1, 0, 0);
+  h.set_edge(2, 0, 3);
+  h.set_edge(3, 0, 2);
+  path.clear();
+  ASSERT_EQ(false, h.directed_eulerian_path(path));
+  ASSERT_EQ(true, path.empty());
+  h.set_edge(1, 0, 2);
+  ASSERT_EQ(true, h.directed_eulerian_path(path));
+  ASSERT_EQ(list<int>({1, 0, 1, 2, 3, 2}), path);
+  h.set_edge(4, 0, 3);
+  path.clear();
+  ASSERT_EQ(false, h.directed_eulerian_path(path));
+}
+
+//hamiltonian paths from the dynamic program and from backtracking
+TEST(AdjacencyMatrixTest, DirectedHamiltonianPath){
+  AdjacencyMatrix g(5);
+  g.set_edge(0, 0, 2);
+  g.set_edge(2, 0, 1);
+  g.set_edge(1, 0, 0);
+  g.set_edge(1, 0, 3);
+  g.set_edge(3, 0, 4);
+  list<int> path;
+  ASSERT_EQ(true, g.directed_hamiltonian_path(path));
+  ASSERT_EQ(list<int>({0, 2, 1, 3, 4}), path);
+  // two vertices without outgoing edges
+  g.set_edge(0, 0, 4);
+  AdjacencyMatrix h(g);
+  h.remove_edge(3, 4);
+  path.clear();
+  ASSERT_EQ(false, h.directed_hamiltonian_path(path));
+  // too large for the dynamic program: a ring with chords
+  int n = Graph::held_karp_max_vertices + 6;
+  AdjacencyMatrix big(n);
+  for (int i = 0; i < n; ++i) {
+    big.set_edge(i, 0, (i + 1) % n);
+    big.set_edge(i, 0, (i + 3) % n);
+  }
+  big.remove_edge(n - 1, 0);
+  path.clear();
+  bool timed_out = true;
+  ASSERT_EQ(true, big.directed_hamiltonian_path(path, 5000, timed_out));
+  ASSERT_EQ(false, timed_out);
+  ASSERT_EQ(n, path.size());
+  int prev = -1;
+  Set seen;
+  for (int v : path) {
+    if (prev != -1)
+      ASSERT_EQ(true, big.has_edge(prev, v));
+    seen.insert(v);
+    prev = v;
+  }
+  ASSERT_EQ(n, seen.size());
+}
+
+//hopcroft-karp finds a maximum matching
+TEST(AdjacencyMatrixTest, BipartiteGraphMatching){
+  AdjacencyMatrix g(8);
+  g.set_edge(0, 0, 1);
+  g.set_edge(0, 0, 3);
+  g.set_edge(2, 0, 1);
+  g.set_edge(4, 0, 3);
+  g.set_edge(4, 0, 5);
+  g.set_edge(6, 0, 5);
+  g.set_edge(7, 0, 6);
+  AdjacencyMatrix matched(8);
+  ASSERT_EQ(true, g.bipartite_graph_matching(matched));
+  ASSERT_EQ(4, matched.edge_count());
+  Set covered;
+  for (int u = 0; u < 8; ++u) {
+    list<int> adj;
+    matched.connected_to(u, adj);
+    for (int v : adj) {
+      ASSERT_EQ(true, g.has_edge(u, v) || g.has_edge(v, u));
+      ASSERT_EQ(0, covered.count(u));
+      ASSERT_EQ(0, covered.count(v));
+      covered.insert(u);
+      covered.insert(v);
+    }
+  }
+  g.set_edge(2, 0, 0);
+  AdjacencyMatrix odd(8);
+  ASSERT_EQ(false, g.bipartite_graph_matching(odd));
+}
+
+//auction finds the minimum cost assignment
+TEST(AdjacencyMatrixTest, MinCostBipartiteAssignment){
+  AdjacencyMatrix g(6);
+  // jobs 0,2,4 (color 1) and workers 1,3,5 (color 0)
+  g.set_edge(0, 4, 1);
+  g.set_edge(0, 1, 3);
+  g.set_edge(0, 3, 5);
+  g.set_edge(2, 2, 1);
+  g.set_edge(2, 0, 3);
+  g.set_edge(2, 5, 5);
+  g.set_edge(4, 3, 1);
+  g.set_edge(5, 2, 4);
+  g.set_edge(4, 2, 3);
+  AdjacencyMatrix assignment(6);
+  long long cost = -1;
+  ASSERT_EQ(true, g.min_cost_bipartite_assignment(assignment, cost));
+  ASSERT_EQ(5, cost);
+  ASSERT_EQ(3, assignment.edge_count());
+  ASSERT_EQ(true, assignment.has_edge(3, 0));
+  ASSERT_EQ(true, assignment.has_edge(1, 2));
+  ASSERT_EQ(true, assignment.has_edge(5, 4));
+  // no perfect matching
+  AdjacencyMatrix h(6);
+  h.set_edge(1, 1, 0);
+  h.set_edge(3, 1, 0);
+  h.set_edge(2, 1, 5);
+  h.set_edge(4, 1, 5);
+  AdjacencyMatrix none(6);
+  ASSERT_EQ(false, h.min_cost_bipartite_assignment(none, cost));
+}
+
+//pivoting bron-kerbosch finds each maximal clique once
+TEST(AdjacencyMatrixTest, MaximalCliques){
+  AdjacencyMatrix g(8);
+  g.set_edge(0, 0, 1);
+  g.set_edge(1, 0, 2);
+  g.set_edge(2, 0, 0);
+  g.set_edge(0, 0, 3);
+  g.set_edge(3, 0, 1);
+  g.set_edge(3, 0, 2);
+  g.set_edge(2, 0, 4);
+  g.set_edge(4, 0, 5);
+  g.set_edge(5, 0, 2);
+  g.set_edge(6, 0, 5);
+  g.set_edge(6, 0, 6);
+  list<Set> found;
+  g.cliques(found);
+  set<Set> cliques(found.begin(), found.end());
+  ASSERT_EQ(4, found.size());
+  ASSERT_EQ(set<Set>({{0, 1, 2, 3}, {2, 4, 5}, {5, 6}, {7}}), cliques);
+}
+
+//streamed cliques match the stored ones and the largest is found
+TEST(AdjacencyMatrixTest, StreamingAndMaximumClique){
+  AdjacencyMatrix g(8);
+  g.set_edge(0, 0, 1);
+  g.set_edge(1, 0, 2);
+  g.set_edge(2, 0, 0);
+  g.set_edge(0, 0, 3);
+  g.set_edge(3, 0, 1);
+  g.set_edge(3, 0, 2);
+  g.set_edge(2, 0, 4);
+  g.set_edge(4, 0, 5);
+  g.set_edge(5, 0, 2);
+  g.set_edge(6, 0, 5);
+  set<Set> streamed;
+  g.cliques(0, [&](const Set& c) { streamed.insert(c); });
+  list<Set> stored;
+  g.cliques(stored);
+  ASSERT_EQ(set<Set>(stored.begin(), stored.end()), streamed);
+  streamed.clear();
+  g.cliques(3, [&](const Set& c) { streamed.insert(c); });
+  ASSERT_EQ(set<Set>({{0, 1, 2, 3}, {2, 4, 5}}), streamed);
+  Set largest;
+  g.maximum_clique(largest);
+  ASSERT_EQ(Set({0, 1, 2, 3}), largest);
+  AdjacencyMatrix empty(3);
+  largest.clear();
+  empty.maximum_clique(largest);
+  ASSERT_EQ(1, largest.size());
+}
+
+//independent set over a forest with vertices in any order
+TEST(AdjacencyMatrixTest, ForestMaxIndependentSet){
+  AdjacencyMatrix g(9);
+  // tree rooted anywhere: 3 - 0 - 5, 0 - 7, 7 - 2
+  g.set_edge(3, 0, 0);
+  g.set_edge(0, 0, 5);
+  g.set_edge(7, 0, 0);
+  g.set_edge(2, 0, 7);
+  // path 8 - 1 - 6, and 4 alone
+  g.set_edge(1, 0, 8);
+  g.set_edge(1, 0, 6);
+  int weights[9] = {10, 5, 1, 3, 2, 4, 3, 9, 3};
+  Set S;
+  ASSERT_EQ(true, g.forest_max_independent_set(weights, S));
+  ASSERT_EQ(Set({3, 5, 7, 4, 8, 6}), S);
+  vector<bool> in_set;
+  long long total = 0;
+  ASSERT_EQ(true, g.forest_max_independent_set(weights, in_set, total));
+  ASSERT_EQ(24, total);
+  // cycle is not a forest
+  g.set_edge(5, 0, 3);
+  ASSERT_EQ(false, g.forest_max_independent_set(weights, in_set, total));
+}
+
+//betweenness on a path, a star, and a weighted detour
+TEST(AdjacencyMatrixTest, BetweennessCentrality){
+  // undirected path 0 - 1 - 2 - 3
+  AdjacencyMatrix g1(4);
+  g1.set_edge(0, 0, 1);
+  g1.set_edge(2, 0, 1);
+  g1.set_edge(2, 0, 3);
+  vector<double> c;
+  g1.betweenness_centrality(false, false, c);
+  ASSERT_EQ(vector<double>({0, 2, 2, 0}), c);
+  // directed, only 0 -> 1 -> 2 -> 3 passes through the middle
+  g1.set_edge(1, 0, 2);
+  g1.betweenness_centrality(true, false, c);
+  ASSERT_EQ(vector<double>({0, 2, 2, 0}), c);
+  // two equal routes 0 -> 1 -> 3 and 0 -> 2 -> 3 split the pair
+  AdjacencyMatrix g2(4);
+  g2.set_edge(0, 1, 1);
+  g2.set_edge(1, 1, 3);
+  g2.set_edge(0, 1, 2);
+  g2.set_edge(2, 1, 3);
+  g2.betweenness_centrality(true, false, c);
+  ASSERT_EQ(vector<double>({0, 0.5, 0.5, 0}), c);
+  // a heavy edge on 1 -> 3 sends the weighted path through 2
+  g2.set_edge(1, 5, 3);
+  g2.betweenness_centrality(true, true, c);
+  ASSERT_EQ(vector<double>({0, 0, 1, 0}), c);
+}
+
+//sampled betweenness is exact with every source and within its bound
+TEST(AdjacencyMatrixTest, ApproximateBetweennessCentrality){
+  AdjacencyMatrix g(6);
+  for (int i = 1; i < 6; ++i)
+    g.set_edge(0, 0, i);
+  vector<double> exact;
+  g.betweenness_centrality(false, false, exact);
+  ASSERT_EQ(10, exact[0]);
+  vector<double> c;
+  ASSERT_EQ(0, g.approximate_betweenness_centrality(false, false, 6, 1, c));
+  ASSERT_EQ(exact, c);
+  double bound = g.approximate_betweenness_centrality(false, false, 3, 1, c);
+  ASSERT_LT(0, bound);
+  for (int v = 0; v < 6; ++v)
+    ASSERT_LE(std::abs(c[v] - exact[v]), bound);
+}
+
+//pagerank on a cycle, a sink, and a personalized batch
+TEST(AdjacencyMatrixTest, PageRank){
+  // a directed cycle ranks every vertex equally
+  AdjacencyMatrix g1(4);
+  for (int i = 0; i < 4; ++i)
+    g1.set_edge(i, 0, (i + 1) % 4);
+  vector<double> ranks;
+  ASSERT_EQ(1, g1.pagerank(0.85, 1e-10, 100, ranks));
+  for (int v = 0; v < 4; ++v)
+    ASSERT_NEAR(0.25, ranks[v], 1e-12);
+  // everything points at 0, which has no out edges
+  AdjacencyMatrix g2(3);
+  g2.set_edge(1, 0, 0);
+  g2.set_edge(2, 0, 0);
+  int iterations = g2.pagerank(0.85, 1e-12, 1000, ranks);
+  ASSERT_LT(1, iterations);
+  ASSERT_GT(1000, iterations);
+  ASSERT_NEAR(1.0, ranks[0] + ranks[1] + ranks[2], 1e-9);
+  ASSERT_GT(ranks[0], ranks[1]);
+  ASSERT_NEAR(ranks[1], ranks[2], 1e-12);
+  // restart at 1 only: 2 is never visited
+  vector<vector<double>> batch;
+  ASSERT_LT(0, g2.personalized_pagerank(0.85, 1e-12, 1000,
+                                        {{1, 1, 1}, {0, 2, 0}}, batch));
+  ASSERT_EQ(2, batch.size());
+  for (int v = 0; v < 3; ++v)
+    ASSERT_NEAR(ranks[v], batch[0][v], 1e-9);
+  ASSERT_NEAR(0.0, batch[1][2], 1e-12);
+  ASSERT_NEAR(1.0, batch[1][0] + batch[1][1], 1e-9);
+  ASSERT_EQ(-1, g2.personalized_pagerank(0.85, 1e-12, 1000, {{0, 0, 0}}, batch));
+}
+
+//triangles, clustering, and transitivity of two triangles sharing an edge
+TEST(AdjacencyMatrixTest, TriangleCount){
+  AdjacencyMatrix g(5);
+  g.set_edge(0, 0, 1);
+  g.set_edge(1, 0, 2);
+  g.set_edge(2, 0, 0);
+  g.set_edge(3, 0, 1);
+  g.set_edge(2, 0, 3);
+  g.set_edge(3, 0, 4);
+  g.set_edge(4, 0, 4);
+  vector<long long> triangles;
+  ASSERT_EQ(2, g.triangle_count(triangles));
+  ASSERT_EQ(vector<long long>({1, 2, 2, 1, 0}), triangles);
+  vector<double> coefficients;
+  g.local_clustering_coefficients(coefficients);
+  ASSERT_NEAR(1.0, coefficients[0], 1e-12);
+  ASSERT_NEAR(2.0 / 3, coefficients[1], 1e-12);
+  ASSERT_NEAR(1.0 / 3, coefficients[3], 1e-12);
+  ASSERT_EQ(0, coefficients[4]);
+  // 6 triangle corners over 1 + 3 + 3 + 3 + 0 triples
+  ASSERT_NEAR(0.6, g.transitivity(), 1e-12);
+  AdjacencyMatrix empty(3);
+  ASSERT_EQ(0, empty.triangle_count());
+  ASSERT_EQ(0, empty.transitivity());
+}
+
+//core numbers of a 4-clique with a tail, and its 3-core
+TEST(AdjacencyMatrixTest, CoreDecomposition){
+  AdjacencyMatrix g(6);
+  for (int u = 0; u < 4; ++u)
+    for (int v = u + 1; v < 4; ++v)
+      g.set_edge(u, 0, v);
+  g.set_edge(3, 0, 4);
+  g.set_edge(4, 0, 5);
+  g.set_edge(5, 0, 5);
+  vector<int> core;
+  vector<int> order;
+  ASSERT_EQ(3, g.core_decomposition(core, order));
+  ASSERT_EQ(vector<int>({3, 3, 3, 3, 1, 1}), core);
+  ASSERT_EQ(6, order.size());
+  vector<int> parallel_core;
+  ASSERT_EQ(3, g.parallel_core_decomposition(parallel_core));
+  ASSERT_EQ(core, parallel_core);
+  AdjacencyMatrix core_graph(6);
+  ASSERT_EQ(4, g.k_core(3, core_graph));
+  ASSERT_EQ(6, core_graph.edge_count());
+  ASSERT_EQ(false, core_graph.has_edge(3, 4));
+}
+
+//max flow and min cut on the classic six vertex network
+TEST(AdjacencyMatrixTest, MaxFlow){
+  AdjacencyMatrix g(6);
+  g.set_edge(0, 16, 1);
+  g.set_edge(0, 13, 2);
+  g.set_edge(1, 12, 3);
+  g.set_edge(2, 4, 1);
+  g.set_edge(2, 14, 4);
+  g.set_edge(3, 9, 2);
+  g.set_edge(3, 20, 5);
+  g.set_edge(4, 7, 3);
+  g.set_edge(4, 4, 5);
+  AdjacencyMatrix flow(6);
+  Set source_side;
+  ASSERT_EQ(23, g.max_flow(0, 5, flow, source_side));
+  ASSERT_EQ(9, flow.edge_count());
+  int f = 0;
+  flow.get_edge(3, 5, f);
+  ASSERT_EQ(19, f);
+  flow.get_edge(4, 5, f);
+  ASSERT_EQ(4, f);
+  ASSERT_EQ(Set({0, 1, 2, 4}), source_side);
+  AdjacencyMatrix baseline(6);
+  Set baseline_side;
+  ASSERT_EQ(23, g.edmonds_karp_max_flow(0, 5, baseline, baseline_side));
+  ASSERT_EQ(source_side, baseline_side);
+  // no path back to the source
+  AdjacencyMatrix none(6);
+  source_side.clear();
+  ASSERT_EQ(0, g.max_flow(5, 0, none, source_side));
+  ASSERT_EQ(Set({5}), source_side);
+}
+
+//louvain splits two cliques joined by a single edge
+TEST(AdjacencyMatrixTest, LouvainCommunities){
+  AdjacencyMatrix g(8);
+  for (int u = 0; u < 4; ++u) {
+    for (int v = u + 1; v < 4; ++v) {
+      g.set_edge(u, 1, v);
+      g.set_edge(u + 4, 1, v + 4);
+    }
+  }
+  g.set_edge(3, 1, 4);
+  Map communities;
+  double modularity = 0;
+  ASSERT_EQ(2, g.louvain_communities(communities, modularity));
+  for (int v = 0; v < 8; ++v)
+    ASSERT_EQ(v < 4 ? 0 : 1, communities[v]);
+  // 12 of the 13 edges are internal, and each side has degree 13
+  ASSERT_NEAR(12.0 / 13 - 0.5, modularity, 1e-12);
+  vector<int> dense;
+  ASSERT_EQ(2, g.louvain_communities(dense, modularity));
+  ASSERT_NEAR(modularity, g.modularity(dense), 1e-12);
+  ASSERT_NEAR(0.0, g.modularity(vector<int>(8, 0)), 1e-12);
+  // no edges leaves every vertex alone
+  AdjacencyMatrix empty(3);
+  ASSERT_EQ(3, empty.louvain_communities(dense, modularity));
+  ASSERT_EQ(0, modularity);
+}
+
+//landmark bounds on a weighted path with a branch
+TEST(AdjacencyMatrixTest, DistanceOracle){
+  // 0 - 1 - 2 - 3 - 4 with 5 hanging off 2, and 6 alone
+  AdjacencyMatrix g(7);
+  g.set_edge(0, 2, 1);
+  g.set_edge(1, 3, 2);
+  g.set_edge(2, 1, 3);
+  g.set_edge(3, 4, 4);
+  g.set_edge(5, 2, 2);
+  DistanceOracle oracle(g, 1, false, true);
+  ASSERT_EQ(1, oracle.landmark_count());
+  long long lower = 0;
+  long long upper = 0;
+  // 2 is the only vertex with three edges, so it is the landmark
+  ASSERT_EQ(true, oracle.distance_bounds(0, 4, lower, upper));
+  ASSERT_EQ(0, lower);
+  ASSERT_EQ(10, upper);
+  ASSERT_EQ(true, oracle.distance_bounds(2, 4, lower, upper));
+  ASSERT_EQ(5, lower);
+  ASSERT_EQ(5, upper);
+  ASSERT_EQ(false, oracle.distance_bounds(0, 6, lower, upper));
+  stringstream stream;
+  oracle.save(stream);
+  DistanceOracle loaded;
+  ASSERT_EQ(true, loaded.load(stream));
+  ASSERT_EQ(7, loaded.vertex_count());
+  ASSERT_EQ(true, loaded.distance_bounds(5, 1, lower, upper));
+  ASSERT_EQ(1, lower);
+  ASSERT_EQ(5, upper);
+  // directed, only forward paths count
+  DistanceOracle directed(g, 2, true, false);
+  ASSERT_EQ(true, directed.distance_bounds(0, 4, lower, upper));
+  ASSERT_LE(lower, 4);
+  ASSERT_EQ(4, upper);
+  ASSERT_EQ(false, directed.distance_bounds(4, 0, lower, upper));
+  stringstream bad("2 1 0 0 5");
+  ASSERT_EQ(false, loaded.load(bad));
+  // negative distances are rejected and the oracle is kept
+  stringstream negative("2 1 0 0  0  0 -3");
+  ASSERT_EQ(false, loaded.load(negative));
+  ASSERT_EQ(7, loaded.vertex_count());
+}
+
+//yen's algorithm lists the alternative routes in order of cost
+TEST(AdjacencyMatrixTest, KShortestPaths){
+  AdjacencyMatrix g(6);
+  g.set_edge(0, 3, 1);
+  g.set_edge(0, 2, 2);
+  g.set_edge(1, 4, 3);
+  g.set_edge(2, 1, 1);
+  g.set_edge(2, 2, 3);
+  g.set_edge(2, 3, 4);
+  g.set_edge(3, 1, 4);
+  g.set_edge(3, 2, 5);
+  g.set_edge(4, 2, 5);
+  g.set_edge(5, 1, 0);
+  vector<list<int>> paths;
+  vector<long long> costs;
+  ASSERT_EQ(3, g.k_shortest_paths(0, 5, 3, paths, costs));
+  ASSERT_EQ(list<int>({0, 2, 3, 5}), paths[0]);
+  ASSERT_EQ(vector<long long>({6, 7, 7}), costs);
+  for (int i = 1; i < 3; ++i)
+    ASSERT_EQ(5, paths[i].back());
+  // only 7 loopless routes exist
+  ASSERT_EQ(7, g.k_shortest_paths(0, 5, 20, paths, costs));
+  ASSERT_EQ(vector<long long>({6, 7, 7, 9, 9, 10, 10}), costs);
+  ASSERT_EQ(0, g.k_shortest_paths(5, 1, 0, paths, costs));
+  ASSERT_EQ(1, g.k_shortest_paths(3, 3, 2, paths, costs));
+  ASSERT_EQ(list<int>({3}), paths[0]);
+}
+
+//a mixed batch of path queries answered on a pool of threads
+TEST(AdjacencyMatrixTest, PathQueryEngine){
+  AdjacencyMatrix g(5);
+  g.set_edge(0, 4, 1);
+  g.set_edge(0, 1, 2);
+  g.set_edge(2, 1, 1);
+  g.set_edge(1, 1, 3);
+  g.set_edge(4, -2, 3);
+  PathQueryEngine engine(g, true, 3);
+  ASSERT_EQ(3, engine.thread_count());
+  vector<PathQuery> queries = {{BFS_PATH, 0, 3},
+                               {DIJKSTRA_PATH, 0, 3},
+                               {BELLMAN_FORD_PATH, 4, 3},
+                               {DIJKSTRA_PATH, 3, 0},
+                               {BFS_PATH, 2, 2}};
+  vector<PathResult> results;
+  engine.run(queries, results);
+  ASSERT_EQ(5, results.size());
+  ASSERT_EQ(2, results[0].cost);
+  ASSERT_EQ(list<int>({0, 1, 3}), results[0].path);
+  ASSERT_EQ(3, results[1].cost);
+  ASSERT_EQ(list<int>({0, 2, 1, 3}), results[1].path);
+  ASSERT_EQ(true, results[2].ok);
+  ASSERT_EQ(-2, results[2].cost);
+  ASSERT_EQ(-1, results[3].cost);
+  ASSERT_EQ(true, results[3].path.empty());
+  ASSERT_EQ(list<int>({2}), results[4].path);
+  // the same engine answers later batches, a negative cycle is reported
+  g.set_edge(3, -5, 4);
+  PathQueryEngine cyclic(g, false, 2);
+  cyclic.run({{BELLMAN_FORD_PATH, 0, 3}, {BFS_PATH, 3, 0}}, results);
+  ASSERT_EQ(false, results[0].ok);
+  ASSERT_EQ(2, results[1].cost);
+  engine.run({{BFS_PATH, 3, 0}}, results);
+  ASSERT_EQ(-1, results[0].cost);
+}
+
 
 
 int main(int argc, char** argv)
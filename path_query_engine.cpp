@@ -0,0 +1,209 @@
+//----------------------------------------------------------------------
+// NAME: Sami Blevens
+// FILE: path_query_engine.cpp
+// DATE: Spring 2021
+// DESC: Answers batches of shortest path queries against a read-only
+// graph on several threads with reusable per-thread buffers
+//----------------------------------------------------------------------
+
+#ifndef PATH_QUERY_ENGINE_CPP
+#define PATH_QUERY_ENGINE_CPP
+
+#include "path_query_engine.h"
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <thread>
+
+PathQueryEngine::PathQueryEngine(const Graph& graph, bool dir, int threads)
+   : number_of_vertices(graph.vertex_count()), directed(dir), batch(nullptr),
+     answers(nullptr), next(0) {
+   int n = number_of_vertices;
+   offsets.assign(n+1, 0);
+   in_offsets.assign(n+1, 0);
+   std::list<int> adj_v;
+   for(int u=0; u<n; ++u){
+      adj_v.clear();
+      graph.connected_to(u,adj_v);
+      adj_v.sort();
+      adj_v.unique();
+      for(int v: adj_v){
+         int label;
+         graph.get_edge(u,v,label);
+         targets.push_back(v);
+         weights.push_back(label);
+      }
+      offsets[u+1] = targets.size();
+      if(!dir){
+         adj_v.clear();
+         graph.connected_from(u,adj_v);
+         adj_v.sort();
+         adj_v.unique();
+         in_targets.insert(in_targets.end(), adj_v.begin(), adj_v.end());
+      }
+      in_offsets[u+1] = in_targets.size();
+   }
+
+   if(threads <= 0)
+      threads = std::max(1u, std::thread::hardware_concurrency());
+   scratch.resize(threads);
+   for(Scratch& s: scratch){
+      s.dist.assign(n, 0);
+      s.parent.assign(n, -1);
+      s.length.assign(n, 0);
+      s.visited.assign(n, 0);
+      s.queued.assign(n, 0);
+      s.stamp = 0;
+   }
+}
+
+void PathQueryEngine::run(const std::vector<PathQuery>& queries,
+                          std::vector<PathResult>& results){
+   results.assign(queries.size(), PathResult());
+   if(queries.empty())
+      return;
+   batch = &queries;
+   answers = &results;
+   next = 0;
+   //the caller is thread 0
+   int threads = std::min<int>(thread_count(), queries.size());
+   std::vector<std::thread> workers;
+   for(int id=1; id<threads; ++id)
+      workers.push_back(std::thread(&PathQueryEngine::drain, this, id));
+   drain(0);
+   for(std::thread& t: workers)
+      t.join();
+   batch = nullptr;
+   answers = nullptr;
+}
+
+int PathQueryEngine::thread_count() const {
+   return scratch.size();
+}
+
+void PathQueryEngine::drain(int id){
+   Scratch& s = scratch[id];
+   int count = batch->size();
+   for(int i = next++; i < count; i = next++){
+      const PathQuery& query = (*batch)[i];
+      PathResult& result = (*answers)[i];
+      result.ok = true;
+      result.cost = -1;
+      if(query.algorithm == BFS_PATH)
+         bfs(query, s, result);
+      else if(query.algorithm == DIJKSTRA_PATH)
+         dijkstra(query, s, result);
+      else
+         bellman_ford(query, s, result);
+   }
+}
+
+void PathQueryEngine::reset(Scratch& s, int src) const {
+   if(s.stamp == std::numeric_limits<int>::max()){
+      std::fill(s.visited.begin(), s.visited.end(), 0);
+      s.stamp = 0;
+   }
+   ++s.stamp;
+   s.visited[src] = s.stamp;
+   s.dist[src] = 0;
+   s.parent[src] = -1;
+   s.length[src] = 0;
+}
+
+void PathQueryEngine::bfs(const PathQuery& query, Scratch& s, PathResult& result) const {
+   reset(s, query.src);
+   s.queue.assign(1, query.src);
+   for(size_t i=0; i<s.queue.size() && s.visited[query.dst] != s.stamp; ++i){
+      int u = s.queue[i];
+      for(int pass=0; pass<(directed ? 1 : 2); ++pass){
+         const std::vector<int>& o = pass == 0 ? offsets : in_offsets;
+         const std::vector<int>& t = pass == 0 ? targets : in_targets;
+         for(int k=o[u]; k<o[u+1]; ++k){
+            int v = t[k];
+            if(s.visited[v] != s.stamp){
+               s.visited[v] = s.stamp;
+               s.dist[v] = s.dist[u] + 1;
+               s.parent[v] = u;
+               s.queue.push_back(v);
+            }
+         }
+      }
+   }
+   trace(query, s, result);
+}
+
+void PathQueryEngine::dijkstra(const PathQuery& query, Scratch& s, PathResult& result) const {
+   typedef std::pair<long long,int> Entry;
+   reset(s, query.src);
+   s.heap.assign(1, Entry(0, query.src));
+   while(!s.heap.empty()){
+      std::pop_heap(s.heap.begin(), s.heap.end(), std::greater<Entry>());
+      Entry top = s.heap.back();
+      s.heap.pop_back();
+      int u = top.second;
+      if(top.first != s.dist[u])
+         continue;
+      if(u == query.dst)
+         break;
+      for(int k=offsets[u]; k<offsets[u+1]; ++k){
+         int v = targets[k];
+         long long d = top.first + weights[k];
+         if(s.visited[v] != s.stamp || d < s.dist[v]){
+            s.visited[v] = s.stamp;
+            s.dist[v] = d;
+            s.parent[v] = u;
+            s.heap.push_back(Entry(d, v));
+            std::push_heap(s.heap.begin(), s.heap.end(), std::greater<Entry>());
+         }
+      }
+   }
+   trace(query, s, result);
+}
+
+void PathQueryEngine::bellman_ford(const PathQuery& query, Scratch& s,
+                                   PathResult& result) const {
+   //queue-based bellman-ford: a vertex is only rescanned after its
+   //distance drops, and a shortest path of n or more edges means a
+   //negative cycle
+   int n = number_of_vertices;
+   reset(s, query.src);
+   s.queue.assign(1, query.src);
+   s.queued[query.src] = 1;
+   for(size_t i=0; i<s.queue.size(); ++i){
+      int u = s.queue[i];
+      s.queued[u] = 0;
+      for(int k=offsets[u]; k<offsets[u+1]; ++k){
+         int v = targets[k];
+         long long d = s.dist[u] + weights[k];
+         if(s.visited[v] != s.stamp || d < s.dist[v]){
+            s.visited[v] = s.stamp;
+            s.dist[v] = d;
+            s.parent[v] = u;
+            s.length[v] = s.length[u] + 1;
+            if(s.length[v] >= n){
+               for(size_t j=i+1; j<s.queue.size(); ++j)
+                  s.queued[s.queue[j]] = 0;
+               result.ok = false;
+               return;
+            }
+            if(!s.queued[v]){
+               s.queued[v] = 1;
+               s.queue.push_back(v);
+            }
+         }
+      }
+   }
+   trace(query, s, result);
+}
+
+void PathQueryEngine::trace(const PathQuery& query, const Scratch& s,
+                            PathResult& result) const {
+   result.path.clear();
+   if(s.visited[query.dst] != s.stamp)
+      return;
+   result.cost = s.dist[query.dst];
+   for(int v=query.dst; v!=-1; v=s.parent[v])
+      result.path.push_front(v);
+}
+
+#endif
@@ -0,0 +1,118 @@
+//----------------------------------------------------------------------
+// NAME: Sami Blevens
+// FILE: path_query_engine.h
+// DATE: Spring 2021
+// DESC: Answers batches of shortest path queries against a read-only
+// graph on several threads with reusable per-thread buffers
+//----------------------------------------------------------------------
+
+#ifndef PATH_QUERY_ENGINE_H
+#define PATH_QUERY_ENGINE_H
+
+#include <atomic>
+#include "graph.h"
+
+
+// algorithms a path query can ask for, matching shortest_path_length,
+// dijkstra_shortest_path, and bellman_ford_shortest_path
+enum PathAlgorithm {
+  BFS_PATH, DIJKSTRA_PATH, BELLMAN_FORD_PATH
+};
+
+// a shortest path query from src to dst
+struct PathQuery {
+  PathAlgorithm algorithm;
+  int src;
+  int dst;
+};
+
+// the answer to a path query
+struct PathResult {
+  // false if a negative cycle is reachable from src (bellman-ford)
+  bool ok;
+  // number of edges (bfs) or total weight of the path, -1 if dst is
+  // unreachable
+  long long cost;
+  // vertices from src to dst (just src if src == dst), empty if dst is
+  // unreachable
+  std::list<int> path;
+};
+
+
+class PathQueryEngine
+{
+public:
+
+  // copy the graph's edges into flat arrays and set up buffers for the
+  // given number of threads (hardware_concurrency if threads is 0). Bfs
+  // queries follow edges in both directions unless dir is true, the
+  // weighted queries assume a directed graph (as
+  // dijkstra_shortest_path does).
+  PathQueryEngine(const Graph& graph, bool dir = true, int threads = 0);
+
+  // answer each query, results[i] is the answer to queries[i]. Threads
+  // take the next unanswered query as they finish, with the calling
+  // thread answering queries too. Each thread keeps its buffers from
+  // batch to batch, so a query costs only the vertices it visits.
+  void run(const std::vector<PathQuery>& queries, std::vector<PathResult>& results);
+
+  // get number of threads answering queries (including the caller)
+  int thread_count() const;
+
+private:
+
+  // per-thread buffers, where dist, parent, and length are only valid
+  // for vertices v with visited[v] == stamp so each query clears them
+  // by bumping the stamp
+  struct Scratch {
+    std::vector<long long> dist;
+    std::vector<int> parent;
+    std::vector<int> length;
+    std::vector<int> visited;
+    std::vector<char> queued;
+    std::vector<int> queue;
+    std::vector<std::pair<long long,int>> heap;
+    int stamp;
+  };
+
+  // out edges as flat arrays (the successors of u are targets[offsets[u]]
+  // up to targets[offsets[u+1]-1], with weights[k] the label of the edge
+  // to targets[k]) and, for undirected bfs, the in edges
+  int number_of_vertices;
+  bool directed;
+  std::vector<int> offsets;
+  std::vector<int> targets;
+  std::vector<int> weights;
+  std::vector<int> in_offsets;
+  std::vector<int> in_targets;
+
+  // buffers for each thread
+  std::vector<Scratch> scratch;
+
+  // the batch being answered
+  const std::vector<PathQuery>* batch;
+  std::vector<PathResult>* answers;
+  std::atomic<int> next;
+
+  // no copies
+  PathQueryEngine(const PathQueryEngine& rhs) = delete;
+  PathQueryEngine& operator=(const PathQueryEngine& rhs) = delete;
+
+  // answer queries of the current batch until none are left
+  void drain(int id);
+
+  // start a query with fresh buffers
+  void reset(Scratch& s, int src) const;
+
+  // single query answers, filling in dist and parent up to dst
+  void bfs(const PathQuery& query, Scratch& s, PathResult& result) const;
+  void dijkstra(const PathQuery& query, Scratch& s, PathResult& result) const;
+  void bellman_ford(const PathQuery& query, Scratch& s, PathResult& result) const;
+
+  // helper function to copy the path to dst out of the parent links
+  void trace(const PathQuery& query, const Scratch& s, PathResult& result) const;
+
+};
+
+
+#endif
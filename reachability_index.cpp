@@ -0,0 +1,233 @@
+//----------------------------------------------------------------------
+// NAME: Sami Blevens
+// FILE: reachability_index.cpp
+// DATE: Spring 2021
+// DESC: Interval-labeling (GRAIL) index over the strongly connected
+// component graph for answering u->v reachability queries
+//----------------------------------------------------------------------
+
+#ifndef REACHABILITY_INDEX_CPP
+#define REACHABILITY_INDEX_CPP
+
+#include "reachability_index.h"
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <unordered_set>
+
+ReachabilityIndex::ReachabilityIndex()
+   : traversals(0) {
+   offsets.push_back(0);
+}
+
+ReachabilityIndex::ReachabilityIndex(const Graph& graph, int traversals)
+   : traversals(std::max(1,traversals)) {
+   int c = graph.strongly_connected_components(components);
+   graph.condensation(true, components, c, offsets, targets);
+
+   tree_pre.assign(c,0);
+   tree_end.assign(c,0);
+   low.assign(this->traversals * c, 0);
+   post.assign(this->traversals * c, 0);
+   for(int t=0; t<this->traversals; ++t){
+      label(t, t + 1);
+   }
+}
+
+bool ReachabilityIndex::reachable(int u, int v) const {
+   int x = components[u];
+   int y = components[v];
+   if(x == y)
+      return true;
+   //components are topologically ordered
+   if(x > y)
+      return false;
+   if(tree_contains(x,y))
+      return true;
+   if(!labels_contain(x,y))
+      return false;
+
+   //guided dfs over the component graph
+   std::vector<int> s(1,x);
+   std::unordered_set<int> visited;
+   visited.insert(x);
+   while(!s.empty()){
+      int z = s.back();
+      s.pop_back();
+      for(int k=offsets[z]; k<offsets[z+1]; ++k){
+         int w = targets[k];
+         if(w == y || tree_contains(w,y))
+            return true;
+         if(w < y && visited.count(w) == 0 && labels_contain(w,y)){
+            visited.insert(w);
+            s.push_back(w);
+         }
+      }
+   }
+   return false;
+}
+
+int ReachabilityIndex::vertex_count() const {
+   return components.size();
+}
+
+void ReachabilityIndex::save(std::ostream& out) const {
+   int n = vertex_count();
+   int c = component_count();
+   out << n << " " << c << " " << targets.size() << " " << traversals << "\n";
+   for(int v: components)
+      out << v << " ";
+   out << "\n";
+   for(int k: offsets)
+      out << k << " ";
+   out << "\n";
+   for(int y: targets)
+      out << y << " ";
+   out << "\n";
+   for(int x=0; x<c; ++x)
+      out << tree_pre[x] << " " << tree_end[x] << " ";
+   out << "\n";
+   for(int i=0; i<traversals*c; ++i)
+      out << low[i] << " " << post[i] << " ";
+   out << "\n";
+}
+
+bool ReachabilityIndex::load(std::istream& in){
+   int n;
+   int c;
+   int m;
+   int t;
+   if(!(in >> n >> c >> m >> t) || n < 0 || c < 0 || m < 0 || t < 0)
+      return false;
+   if(c > 0 && t > std::numeric_limits<int>::max() / c)
+      return false;
+   //read into locals so a bad stream leaves the index unchanged
+   std::vector<int> in_components(n,0);
+   std::vector<int> in_offsets(c+1,0);
+   std::vector<int> in_targets(m,0);
+   std::vector<int> in_tree_pre(c,0);
+   std::vector<int> in_tree_end(c,0);
+   std::vector<int> in_low(t*c,0);
+   std::vector<int> in_post(t*c,0);
+   for(int i=0; i<n; ++i)
+      in >> in_components[i];
+   for(int i=0; i<=c; ++i)
+      in >> in_offsets[i];
+   for(int i=0; i<m; ++i)
+      in >> in_targets[i];
+   for(int x=0; x<c; ++x)
+      in >> in_tree_pre[x] >> in_tree_end[x];
+   for(int i=0; i<t*c; ++i)
+      in >> in_low[i] >> in_post[i];
+   if(!in)
+      return false;
+   for(int v: in_components){
+      if(v < 0 || v >= c)
+         return false;
+   }
+   for(int y: in_targets){
+      if(y < 0 || y >= c)
+         return false;
+   }
+   if(in_offsets[0] != 0 || in_offsets[c] != m)
+      return false;
+   for(int x=0; x<c; ++x){
+      if(in_offsets[x] > in_offsets[x+1])
+         return false;
+   }
+   components.swap(in_components);
+   offsets.swap(in_offsets);
+   targets.swap(in_targets);
+   tree_pre.swap(in_tree_pre);
+   tree_end.swap(in_tree_end);
+   low.swap(in_low);
+   post.swap(in_post);
+   traversals = t;
+   return true;
+}
+
+int ReachabilityIndex::component_count() const {
+   return offsets.size() - 1;
+}
+
+bool ReachabilityIndex::tree_contains(int x, int y) const {
+   return tree_pre[x] <= tree_pre[y] && tree_pre[y] <= tree_end[x];
+}
+
+bool ReachabilityIndex::labels_contain(int x, int y) const {
+   int c = component_count();
+   for(int t=0; t<traversals; ++t){
+      int i = t*c + x;
+      int j = t*c + y;
+      if(low[j] < low[i] || post[j] > post[i])
+         return false;
+   }
+   return true;
+}
+
+void ReachabilityIndex::label(int t, unsigned seed){
+   int c = component_count();
+   int* t_low = &low[t*c];
+   int* t_post = &post[t*c];
+   std::mt19937 rng(seed);
+
+   //roots (and children) are visited in a random order except on the
+   //first traversal, which also records the dfs forest
+   std::vector<int> roots;
+   for(int x=0; x<c; ++x)
+      roots.push_back(x);
+   if(t > 0)
+      std::shuffle(roots.begin(), roots.end(), rng);
+   std::vector<int> children(targets);
+   if(t > 0){
+      for(int x=0; x<c; ++x)
+         std::shuffle(children.begin() + offsets[x], children.begin() + offsets[x+1], rng);
+   }
+
+   std::vector<bool> visited(c,false);
+   std::vector<int> call_x;
+   std::vector<int> call_edge;
+   int next_pre = 0;
+   int next_post = 0;
+   for(int r: roots){
+      if(visited[r])
+         continue;
+      visited[r] = true;
+      if(t == 0)
+         tree_pre[r] = next_pre++;
+      t_low[r] = std::numeric_limits<int>::max();
+      call_x.push_back(r);
+      call_edge.push_back(offsets[r]);
+      while(!call_x.empty()){
+         int x = call_x.back();
+         int k = call_edge.back();
+         if(k < offsets[x+1]){
+            call_edge.back() = k + 1;
+            int y = children[k];
+            if(!visited[y]){
+               visited[y] = true;
+               if(t == 0)
+                  tree_pre[y] = next_pre++;
+               t_low[y] = std::numeric_limits<int>::max();
+               call_x.push_back(y);
+               call_edge.push_back(offsets[y]);
+            } else {
+               t_low[x] = std::min(t_low[x], t_low[y]);
+            }
+            continue;
+         }
+         call_x.pop_back();
+         call_edge.pop_back();
+         t_post[x] = next_post++;
+         t_low[x] = std::min(t_low[x], t_post[x]);
+         if(t == 0)
+            tree_end[x] = next_pre - 1;
+         if(!call_x.empty()){
+            int p = call_x.back();
+            t_low[p] = std::min(t_low[p], t_low[x]);
+         }
+      }
+   }
+}
+
+#endif
@@ -0,0 +1,81 @@
+//----------------------------------------------------------------------
+// NAME: Sami Blevens
+// FILE: reachability_index.h
+// DATE: Spring 2021
+// DESC: Interval-labeling (GRAIL) index over the strongly connected
+// component graph for answering u->v reachability queries
+//----------------------------------------------------------------------
+
+#ifndef REACHABILITY_INDEX_H
+#define REACHABILITY_INDEX_H
+
+#include <iostream>
+#include "graph.h"
+
+
+class ReachabilityIndex
+{
+public:
+
+  // empty index (to be filled in by load)
+  ReachabilityIndex();
+
+  // build the index for the given (directed) graph using the given
+  // number of randomized interval labelings
+  ReachabilityIndex(const Graph& graph, int traversals = 3);
+
+  // returns true if there is a (possibly empty) path from u to v.
+  // Answered in constant time when u and v share a component, when v
+  // is in u's dfs subtree, or when an interval label rules v out;
+  // otherwise falls back to a dfs of the component graph pruned by
+  // the labels.
+  bool reachable(int u, int v) const;
+
+  // get number of vertices indexed
+  int vertex_count() const;
+
+  // write the index as whitespace-separated integers
+  void save(std::ostream& out) const;
+
+  // read an index written by save, returns false if it is malformed
+  bool load(std::istream& in);
+  
+private:
+
+  // component of each vertex (numbered in topological order)
+  std::vector<int> components;
+
+  // edges between components in flat arrays, the successors of x are
+  // targets[offsets[x]] up to targets[offsets[x+1]-1]
+  std::vector<int> offsets;
+  std::vector<int> targets;
+
+  // pre-order number of each component in the first dfs forest and the
+  // largest pre-order number in its subtree
+  std::vector<int> tree_pre;
+  std::vector<int> tree_end;
+
+  // interval labels [low, post] for each traversal, stored as
+  // low[t*c + x] and post[t*c + x] for component x
+  int traversals;
+  std::vector<int> low;
+  std::vector<int> post;
+
+  // number of components
+  int component_count() const;
+
+  // true if y is in x's dfs subtree (so x reaches y)
+  bool tree_contains(int x, int y) const;
+
+  // true if every interval label of x contains the label of y (required
+  // for x to reach y)
+  bool labels_contain(int x, int y) const;
+
+  // helper function to compute one interval labeling (and the dfs
+  // forest on the first traversal)
+  void label(int t, unsigned seed);
+
+};
+
+
+#endif